@@ -0,0 +1,64 @@
+#include "arena.hpp"
+#include <cstdint>
+#include <cstdlib>
+
+/*
+Returns memory of the given size and alignment, starting a new block when the current one is full
+*/
+void * Arena::allocate(size_t size, size_t alignment)
+{
+	if (blocks != nullptr)
+	{
+		uintptr_t start = reinterpret_cast<uintptr_t>(blocks + 1);
+		uintptr_t p = (start + blocks->used + alignment - 1) & ~uintptr_t(alignment - 1);
+		if (p + size <= start + blocks->size)
+		{
+			blocks->used = p + size - start;
+			bytes_allocated += size;
+			return reinterpret_cast<void *>(p);
+		}
+	}
+
+	size_t capacity = size + alignment > block_size ? size + alignment : block_size;
+	block * b = static_cast<block *>(std::malloc(sizeof(block) + capacity));
+	if (b == nullptr) throw std::bad_alloc();
+	b->next = blocks;
+	b->size = capacity;
+	b->used = 0;
+	blocks = b;
+	return allocate(size, alignment);
+}
+
+/*
+Remembers an object to be destroyed when the arena is released
+*/
+void Arena::addDestructor(void (*f)(void *), void * object)
+{
+	destructor * d = new (allocate(sizeof(destructor), alignof(destructor))) destructor;
+	d->function = f;
+	d->object = object;
+	d->next = destructors;
+	destructors = d;
+}
+
+/*
+Destroys all objects in the reverse order of their construction and frees every block
+*/
+void Arena::release()
+{
+	while (destructors != nullptr)
+	{
+		destructor * d = destructors;
+		destructors = d->next;
+		d->function(d->object);
+	}
+
+	while (blocks != nullptr)
+	{
+		block * b = blocks;
+		blocks = b->next;
+		std::free(b);
+	}
+
+	bytes_allocated = 0;
+}
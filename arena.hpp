@@ -0,0 +1,104 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+/*
+Contiguous range of elements allocated in an arena, used for the bodies and argument lists of the syntax tree
+*/
+template <typename T>
+class Span
+{
+public:
+	Span() = default;
+	Span(T * f, size_t n) : first(f), count(n) {}
+	T * begin() const { return first; }
+	T * end() const { return first + count; }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	T & operator[](size_t i) const { return first[i]; }
+
+private:
+	T * first = nullptr;
+	size_t count = 0;
+};
+
+/*
+Region of memory from which objects are allocated by bumping a pointer; the objects are never freed
+one by one, all of them are destroyed and their memory given back at once when the arena is released
+*/
+class Arena
+{
+public:
+	Arena() = default;
+	Arena(const Arena &) = delete;
+	Arena & operator=(const Arena &) = delete;
+	~Arena() { release(); }
+
+	/*
+	Constructs an object in the arena, registering its destructor unless it has nothing to destroy
+	*/
+	template <typename T, typename... Args>
+	T * make(Args &&... args)
+	{
+		T * object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		if (!std::is_trivially_destructible<T>::value) addDestructor(&destroy<T>, object);
+		return object;
+	}
+
+	/*
+	Allocates an uninitialised array of elements which need no destructor
+	*/
+	template <typename T>
+	Span<T> makeArray(size_t n)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "Arena arrays hold trivially destructible elements only");
+		return Span<T>(static_cast<T *>(allocate(n * sizeof(T), alignof(T))), n);
+	}
+
+	/*
+	Copies a range of elements into a new array in the arena
+	*/
+	template <typename T>
+	Span<T> copy(const T * first, size_t n)
+	{
+		Span<T> s = makeArray<T>(n);
+		std::copy(first, first + n, s.begin());
+		return s;
+	}
+
+	void * allocate(size_t size, size_t alignment);
+	void release();
+	size_t bytesAllocated() const { return bytes_allocated; }
+
+private:
+	struct block
+	{
+		block * next;
+		size_t size;
+		size_t used;
+	};
+
+	struct destructor
+	{
+		void (*function)(void *);
+		void * object;
+		destructor * next;
+	};
+
+	template <typename T>
+	static void destroy(void * p) { static_cast<T *>(p)->~T(); }
+	void addDestructor(void (*f)(void *), void * object);
+
+	static const size_t block_size = 16 * 1024;
+	block * blocks = nullptr;
+	destructor * destructors = nullptr;
+	size_t bytes_allocated = 0;
+};
+
+#endif
@@ -0,0 +1,658 @@
+#include "model.hpp"
+#include "raster.hpp"
+#include "drawingstore.hpp"
+#include "vectorsink.hpp"
+#include "trace.hpp"
+#include "png.hpp"
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <vector>
+
+/*
+Named program used as the input of the benchmarks
+*/
+struct workload
+{
+	std::string name;
+	std::string text;
+};
+
+/*
+A function calling itself the given number of times before returning, called a few times over
+*/
+static std::string deepRecursion(int depth)
+{
+	std::ostringstream s;
+	s << "to down n if n > 0 [ down n - 1 ] end repeat 20 [ down " << depth << " ]";
+	return s.str();
+}
+
+/*
+A single repeat loop with a short body
+*/
+static std::string longRepeat(int repetitions)
+{
+	std::ostringstream s;
+	s << "make s 0 make t 0 repeat " << repetitions << " [ make s s + 1 make t t + s ]";
+	return s.str();
+}
+
+/*
+A loop evaluating a long arithmetic expression with variables, parentheses and every operator
+*/
+static std::string heavyArithmetic(int repetitions)
+{
+	std::ostringstream s;
+	s << "make x 1 make y 7 repeat " << repetitions
+		<< " [ make x ( x * 3 + y ) / 2 - x * 5 + ( 1 + 2 ) * ( 3 + 4 ) - ( y - x ) / ( 1 + 1 ) * 3 + x - y * 2 ]";
+	return s.str();
+}
+
+/*
+Many function definitions, each one called once
+*/
+static std::string manyFunctions(int count)
+{
+	std::ostringstream s;
+	for (int i = 0; i < count; i++)
+	{
+		s << "to f" << i << " a b make c a * b + " << i << " output c - a end\n";
+	}
+	for (int i = 0; i < count; i++)
+	{
+		s << "make r f" << i << " " << i << " 3\n";
+	}
+	return s.str();
+}
+
+/*
+Nested repeat loops drawing with the turtle, the scaled up sample from the README
+*/
+static std::string nestedDrawing(int repetitions)
+{
+	std::ostringstream s;
+	s << "repeat " << repetitions << " [ repeat 9 [pu fd 8 pd repeat 4 [ fd 5 rt 900] fd 5] rt 10 ]";
+	return s.str();
+}
+
+/*
+Straight-line code made almost only of identifiers and keywords, most of them longer than any keyword
+*/
+static std::string identifierHeavy(int count)
+{
+	std::ostringstream s;
+	s << "make counter 0 make step_size 1\n";
+	for (int i = 0; i < count; i++)
+	{
+		s << "make value_" << i << " counter + step_size make counter value_" << i
+			<< " pu fd step_size pd rt counter lt step_size if counter > step_size [ make heading_value getheading ]\n";
+	}
+	return s.str();
+}
+
+/*
+Returns the synthetic workloads shared by the lexer, parser and evaluator benchmarks
+*/
+static const std::vector<workload> & syntheticWorkloads()
+{
+	static const std::vector<workload> w = {
+		{ "deep_recursion", deepRecursion(1000) },
+		{ "long_repeat", longRepeat(100000) },
+		{ "heavy_arithmetic", heavyArithmetic(10000) },
+		{ "many_functions", manyFunctions(500) },
+		{ "nested_drawing", nestedDrawing(100) },
+		{ "identifiers", identifierHeavy(2000) },
+	};
+	return w;
+}
+
+/*
+The sample programs of the README, in the order a user would type them; short_distance is defined
+first because the sample drawing rectangles expects it
+*/
+static const std::vector<std::string> & readmeSamples()
+{
+	static const std::vector<std::string> s = {
+		"fd 100",
+		"make long_distance 50\nbk long_distance * 2",
+		"make short_distance 20",
+		"home cs\npu move -1 * short_distance gety\nmove getx (-1 * long_distance) pd\nrepeat 9 [pu fd 8 pd repeat 4 [ fd 5 rt 900] fd 5]",
+		"setxy 200 200 cs to square a pu fd a lt 900 pd \nrepeat 2 [ setcolor getx gety 255 fd a lt 900] \npu fd a lt 900 pd end make b 1 repeat 80 [square b make b b+1]",
+	};
+	return s;
+}
+
+/*
+Tokenises the whole text
+*/
+static void benchmarkLexer(benchmark::State & state, const std::string & text)
+{
+	int64_t tokens = 0;
+	for (auto _ : state)
+	{
+		Source s;
+		Lexer l(&s);
+		s.wrap(text.data(), text.size());
+		l.updateLexer();
+		while (l.getNextToken().type != T_END_OF_TEXT)
+		{
+			tokens++;
+		}
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(text.size()));
+	state.counters["tokens"] = benchmark::Counter(double(tokens), benchmark::Counter::kIsRate);
+}
+
+/*
+Builds the syntax tree of the whole text and releases it
+*/
+static void benchmarkParser(benchmark::State & state, const std::string & text)
+{
+	for (auto _ : state)
+	{
+		Source s;
+		Lexer l(&s);
+		s.wrap(text.data(), text.size());
+		l.updateLexer();
+		ProgramContext pc;
+		Arena definitions;
+		Parser p(&l, &pc, &definitions);
+		StartingStatement * statement = p.doStartingStatement();
+		if (statement == nullptr)
+		{
+			state.SkipWithError(pc.readFromErrorLog().c_str());
+			break;
+		}
+		delete statement;
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(text.size()));
+}
+
+/*
+Parses and executes the text on a new model drawing to a null sink, with the bytecode VM or the tree walker
+*/
+static void benchmarkEvaluator(benchmark::State & state, const std::string & text, bool reference)
+{
+	NullSink sink;
+	for (auto _ : state)
+	{
+		Model m(&sink, reference);
+		OutputLog * log = m.processStatements(text);
+		bool failed = !log->err_log.empty();
+		if (failed) state.SkipWithError(log->err_log.c_str());
+		delete log;
+		if (failed) break;
+	}
+}
+
+/*
+Replays the README samples one statement at a time, as typed in the window, on the given sink
+*/
+static void replayReadme(benchmark::State & state, RenderSink * sink, bool reference)
+{
+	for (auto _ : state)
+	{
+		Model m(sink, reference);
+		for (std::vector<std::string>::const_iterator i = readmeSamples().begin(); i != readmeSamples().end(); i++)
+		{
+			delete m.processStatements(*i);
+		}
+	}
+}
+
+/*
+Macro benchmark of the README samples with the drawing calls discarded
+*/
+static void benchmarkReadmeNull(benchmark::State & state, bool reference)
+{
+	NullSink sink;
+	replayReadme(state, &sink, reference);
+}
+
+/*
+Macro benchmark of the README samples with the drawing calls recorded as text
+*/
+static void benchmarkReadmeRecord(benchmark::State & state, bool reference)
+{
+	std::ostringstream out;
+	RecordingSink sink(out);
+	replayReadme(state, &sink, reference);
+	state.counters["recorded_bytes"] = double(out.tellp()) / double(state.iterations());
+}
+
+/*
+Macro benchmark of the README samples with the lines continuing each other merged, then recorded as text
+*/
+static void benchmarkReadmeCoalesced(benchmark::State & state, bool reference)
+{
+	std::ostringstream out;
+	RecordingSink sink(out);
+	for (auto _ : state)
+	{
+		Model m(&sink, reference);
+		m.setCoalescing(true);
+		for (std::vector<std::string>::const_iterator i = readmeSamples().begin(); i != readmeSamples().end(); i++)
+		{
+			delete m.processStatements(*i);
+		}
+	}
+	state.counters["recorded_bytes"] = double(out.tellp()) / double(state.iterations());
+}
+
+/*
+Macro benchmark of the README samples drawn into a framebuffer by the software rasterizer
+*/
+static void benchmarkReadmeRaster(benchmark::State & state, bool reference)
+{
+	RasterSink sink;
+	replayReadme(state, &sink, reference);
+}
+
+/*
+Encodes the framebuffer drawn by the README samples as PNG
+*/
+static void benchmarkPngEncode(benchmark::State & state)
+{
+	RasterSink sink;
+	Model m(&sink);
+	for (std::vector<std::string>::const_iterator i = readmeSamples().begin(); i != readmeSamples().end(); i++)
+	{
+		delete m.processStatements(*i);
+	}
+	const Framebuffer & f = sink.getFramebuffer();
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		std::ostringstream out;
+		writePng(out, f.data(), f.getWidth(), f.getHeight());
+		bytes = size_t(out.tellp());
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * f.getWidth() * f.getHeight() * 4);
+	state.counters["png_bytes"] = double(bytes);
+}
+
+/*
+Macro benchmark of the README samples with the drawing calls batched in a command buffer and recorded as text
+*/
+static void benchmarkReadmeBuffered(benchmark::State & state, bool reference)
+{
+	std::ostringstream out;
+	RecordingSink sink(out);
+	CommandBuffer buffer(&sink);
+	for (auto _ : state)
+	{
+		Model m(&buffer, reference);
+		for (std::vector<std::string>::const_iterator i = readmeSamples().begin(); i != readmeSamples().end(); i++)
+		{
+			delete m.processStatements(*i);
+			buffer.flush();
+		}
+	}
+	state.counters["recorded_bytes"] = double(out.tellp()) / double(state.iterations());
+}
+
+/*
+Render sink keeping the drawing calls it is given in batches, to draw them again without interpreting the program
+*/
+class CaptureSink : public RenderSink
+{
+public:
+	void drawLine2Point(int, int, int, int) {}
+	void drawLinePointAngleLength(int, int, int, int) {}
+	void moveTurtle2Point(int, int) {}
+	void moveTurtlePointAngleLength(int, int, int, int) {}
+	void clearScreen() {}
+	void updateColor(int, int, int) {}
+	void drawCommands(const render_command * first, size_t count) { commands.insert(commands.end(), first, first + count); }
+
+	std::vector<render_command> commands;
+};
+
+/*
+The drawing calls of the README rectangle samples scaled sixteen times, for a canvas of 8000x8000 pixels, without the clears
+*/
+static const std::vector<render_command> & scaledRectangles()
+{
+	static std::vector<render_command> commands;
+	if (!commands.empty()) return commands;
+
+	CaptureSink capture;
+	CommandBuffer buffer(&capture, std::chrono::hours(1));
+	Model m(&buffer);
+	delete m.processStatements("pu setxy 4000 4000 pd repeat 9 [pu fd 128 pd repeat 4 [ fd 80 rt 900] fd 80]");
+	delete m.processStatements("pu setxy 3200 3200 pd to square a pu fd a lt 900 pd \nrepeat 2 [ setcolor getx gety 255 fd a lt 900] \n"
+		"pu fd a lt 900 pd end make b 1 repeat 1280 [square b make b b+1]");
+	buffer.flush();
+	for (std::vector<render_command>::const_iterator i = capture.commands.begin(); i != capture.commands.end(); i++)
+	{
+		if (i->type != RC_CLEAR) commands.push_back(*i);
+	}
+	return commands;
+}
+
+/*
+Draws the scaled README rectangles on an 8000x8000 canvas with the given span kernel
+*/
+static void benchmarkRasterRectangles(benchmark::State & state, span_kernel k)
+{
+	RasterSink sink(8000, 8000);
+	if (!sink.setSpanKernel(k))
+	{
+		state.SkipWithError("span kernel not supported by this processor");
+		return;
+	}
+	const std::vector<render_command> & commands = scaledRectangles();
+	for (auto _ : state)
+	{
+		sink.drawCommands(commands.data(), commands.size());
+	}
+	state.counters["commands"] = benchmark::Counter(double(commands.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/*
+Draws the scaled README rectangles on an 8000x8000 canvas by tiles on the given number of threads
+*/
+static void benchmarkRasterTiled(benchmark::State & state, unsigned threads)
+{
+	RasterSink sink(8000, 8000);
+	sink.setThreads(threads);
+	const std::vector<render_command> & commands = scaledRectangles();
+	for (auto _ : state)
+	{
+		sink.drawCommands(commands.data(), commands.size());
+	}
+	state.counters["commands"] = benchmark::Counter(double(commands.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/*
+Keeps the scaled README rectangles in a drawing store, indexing them and culling the lines later ones cover
+*/
+static void benchmarkStoreInsert(benchmark::State & state)
+{
+	const std::vector<render_command> & commands = scaledRectangles();
+	DrawingStore store;
+	for (auto _ : state)
+	{
+		store.clearScreen();
+		store.drawCommands(commands.data(), commands.size());
+	}
+	state.counters["lines"] = double(store.size());
+	state.counters["culled"] = double(store.getCulled());
+}
+
+/*
+A hundred thousand lines between pseudo-random points of a 500x500 area, in every direction and crossing each other
+*/
+static const std::vector<render_command> & denseLines()
+{
+	static std::vector<render_command> commands;
+	if (!commands.empty()) return commands;
+
+	uint32_t state = 1;
+	auto next = [&state]() { state = state * 1103515245u + 12345u; return int((state >> 8) % 500); };
+	for (int i = 0; i < 100000; i++)
+	{
+		int x1 = next();
+		int y1 = next();
+		int x2 = next();
+		int y2 = next();
+		commands.push_back({ (unsigned char)RC_LINE, x1, y1, x2, y2 });
+	}
+	return commands;
+}
+
+/*
+Keeps a hundred thousand crossing lines of one area in a drawing store
+*/
+static void benchmarkStoreDense(benchmark::State & state)
+{
+	const std::vector<render_command> & commands = denseLines();
+	DrawingStore store;
+	for (auto _ : state)
+	{
+		store.clearScreen();
+		store.drawCommands(commands.data(), commands.size());
+	}
+	state.counters["lines"] = benchmark::Counter(double(commands.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/*
+Paints the whole of the scaled README rectangles into a view of 500x500 pixels, from the level of the pyramid for its scale
+*/
+static void benchmarkStoreOverview(benchmark::State & state)
+{
+	const std::vector<render_command> & commands = scaledRectangles();
+	DrawingStore store;
+	store.drawCommands(commands.data(), commands.size());
+	std::vector<uint32_t> pixels;
+	drawing_rect view = { 0, 0, 8000, 8000 };
+	drawing_rect blocks;
+	int level = DrawingStore::levelForScale(500.0 / 8000.0);
+	for (auto _ : state)
+	{
+		store.renderLevel(level, view, blocks, pixels);
+		benchmark::DoNotOptimize(pixels.data());
+	}
+	state.counters["level"] = double(level);
+	state.counters["pixels"] = double(pixels.size());
+	state.counters["lines"] = double(store.size());
+}
+
+/*
+Finds the lines of the scaled README rectangles a view of 500x500 pixels around the corner they grow from shows
+*/
+static void benchmarkStoreViewport(benchmark::State & state)
+{
+	const std::vector<render_command> & commands = scaledRectangles();
+	DrawingStore store;
+	store.drawCommands(commands.data(), commands.size());
+	std::vector<uint32_t> found;
+	drawing_rect view = { 2950, 2950, 3450, 3450 };
+	for (auto _ : state)
+	{
+		store.query(view, found);
+	}
+	state.counters["found"] = double(found.size());
+}
+
+/*
+Streams the scaled README rectangles as an SVG document
+*/
+static void benchmarkSvg(benchmark::State & state)
+{
+	const std::vector<render_command> & commands = scaledRectangles();
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		std::ostringstream out;
+		SvgSink sink(out, 8000, 8000);
+		sink.drawCommands(commands.data(), commands.size());
+		sink.finish();
+		bytes = size_t(out.tellp());
+	}
+	state.counters["svg_bytes"] = double(bytes);
+	state.counters["commands"] = benchmark::Counter(double(commands.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/*
+Streams the scaled README rectangles as a binary list of lines
+*/
+static void benchmarkLineList(benchmark::State & state)
+{
+	const std::vector<render_command> & commands = scaledRectangles();
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		std::ostringstream out;
+		LineListSink sink(out, 8000, 8000);
+		sink.drawCommands(commands.data(), commands.size());
+		sink.finish();
+		bytes = size_t(out.tellp());
+	}
+	state.counters["list_bytes"] = double(bytes);
+	state.counters["commands"] = benchmark::Counter(double(commands.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/*
+Records the scaled README rectangles into a drawing trace
+*/
+static void benchmarkTraceRecord(benchmark::State & state)
+{
+	const std::vector<render_command> & commands = scaledRectangles();
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		std::ostringstream out;
+		TraceRecorder recorder(out);
+		recorder.drawCommands(commands.data(), commands.size());
+		recorder.finish();
+		bytes = size_t(out.tellp());
+	}
+	state.counters["trace_bytes"] = double(bytes);
+	state.counters["commands"] = benchmark::Counter(double(commands.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/*
+Replays the trace of the scaled README rectangles into a sink discarding the calls
+*/
+static void benchmarkTraceReplay(benchmark::State & state)
+{
+	const std::vector<render_command> & commands = scaledRectangles();
+	std::ostringstream out;
+	TraceRecorder recorder(out);
+	recorder.drawCommands(commands.data(), commands.size());
+	recorder.finish();
+	std::string trace = out.str();
+	NullSink sink;
+	for (auto _ : state)
+	{
+		if (!replayTrace(trace.data(), trace.size(), &sink)) state.SkipWithError("invalid trace");
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(trace.size()));
+	state.counters["commands"] = benchmark::Counter(double(commands.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/*
+Draws the part of a line going 80000 pixels right and 70000 down which crosses a 500x500 canvas, antialiased;
+checks first that every pixel of the aliased line is touched by the antialiased one, as a wrong slope would not
+*/
+static void benchmarkRasterLongLine(benchmark::State & state)
+{
+	raster_clip clip = { 0, 0, 500, 500 };
+	Framebuffer aliased(500, 500);
+	Framebuffer antialiased(500, 500);
+	aliased.fill(Framebuffer::pack(255, 255, 255));
+	antialiased.fill(Framebuffer::pack(255, 255, 255));
+	LineRasterizer plain(aliased, clip, getSpanFill(SPAN_SCALAR));
+	LineRasterizer smooth(antialiased, clip, getSpanFill(SPAN_SCALAR));
+	plain.drawLine(0, 0, 80000, 70000);
+	smooth.drawLineAntialiased(0, 0, 80000, 70000);
+	for (size_t i = 0; i < size_t(500 * 500); i++)
+	{
+		if (aliased.data()[i] != Framebuffer::pack(255, 255, 255) && antialiased.data()[i] == Framebuffer::pack(255, 255, 255))
+		{
+			state.SkipWithError("antialiased line leaves the aliased one");
+			return;
+		}
+	}
+
+	for (auto _ : state)
+	{
+		smooth.drawLineAntialiased(0, 0, 80000, 70000);
+	}
+}
+
+/*
+Clears an 8000x8000 canvas with the given span kernel
+*/
+static void benchmarkRasterClear(benchmark::State & state, span_kernel k)
+{
+	RasterSink sink(8000, 8000);
+	if (!sink.setSpanKernel(k))
+	{
+		state.SkipWithError("span kernel not supported by this processor");
+		return;
+	}
+	for (auto _ : state)
+	{
+		sink.clearScreen();
+	}
+	state.SetBytesProcessed(int64_t(state.iterations()) * 8000 * 8000 * 4);
+}
+
+/*
+End points of forward moves over every heading of a turn
+*/
+static void benchmarkPolarEndPoint(benchmark::State & state)
+{
+	int x = 0;
+	int y = 0;
+	for (auto _ : state)
+	{
+		for (int angle = 0; angle < FULL_TURN; angle++)
+		{
+			polarEndPoint(x & 0xff, y & 0xff, 100, angle, x, y);
+		}
+		benchmark::DoNotOptimize(x);
+		benchmark::DoNotOptimize(y);
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * FULL_TURN);
+}
+
+/*
+Registers one benchmark of every kind for every workload
+*/
+static void registerBenchmarks()
+{
+	for (std::vector<workload>::const_iterator w = syntheticWorkloads().begin(); w != syntheticWorkloads().end(); w++)
+	{
+		benchmark::RegisterBenchmark(("lex/" + w->name).c_str(), benchmarkLexer, w->text);
+		benchmark::RegisterBenchmark(("parse/" + w->name).c_str(), benchmarkParser, w->text);
+		benchmark::RegisterBenchmark(("vm/" + w->name).c_str(), benchmarkEvaluator, w->text, false)->Unit(benchmark::kMillisecond);
+		benchmark::RegisterBenchmark(("tree/" + w->name).c_str(), benchmarkEvaluator, w->text, true)->Unit(benchmark::kMillisecond);
+	}
+
+	benchmark::RegisterBenchmark("readme/null/vm", benchmarkReadmeNull, false);
+	benchmark::RegisterBenchmark("readme/null/tree", benchmarkReadmeNull, true);
+	benchmark::RegisterBenchmark("readme/record/vm", benchmarkReadmeRecord, false);
+	benchmark::RegisterBenchmark("readme/record/tree", benchmarkReadmeRecord, true);
+	benchmark::RegisterBenchmark("readme/coalesced/vm", benchmarkReadmeCoalesced, false);
+	benchmark::RegisterBenchmark("readme/coalesced/tree", benchmarkReadmeCoalesced, true);
+	benchmark::RegisterBenchmark("readme/buffered/vm", benchmarkReadmeBuffered, false);
+	benchmark::RegisterBenchmark("readme/buffered/tree", benchmarkReadmeBuffered, true);
+	benchmark::RegisterBenchmark("readme/raster/vm", benchmarkReadmeRaster, false);
+	benchmark::RegisterBenchmark("readme/raster/tree", benchmarkReadmeRaster, true);
+	benchmark::RegisterBenchmark("geometry/polar_end_point", benchmarkPolarEndPoint);
+	benchmark::RegisterBenchmark("store/8k_rectangles/insert", benchmarkStoreInsert)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("store/8k_rectangles/viewport", benchmarkStoreViewport);
+	benchmark::RegisterBenchmark("store/8k_rectangles/overview", benchmarkStoreOverview);
+	benchmark::RegisterBenchmark("store/dense_100k/insert", benchmarkStoreDense)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("vector/8k_rectangles/svg", benchmarkSvg);
+	benchmark::RegisterBenchmark("vector/8k_rectangles/lines", benchmarkLineList);
+	benchmark::RegisterBenchmark("trace/8k_rectangles/record", benchmarkTraceRecord);
+	benchmark::RegisterBenchmark("trace/8k_rectangles/replay", benchmarkTraceReplay);
+	benchmark::RegisterBenchmark("png/encode", benchmarkPngEncode)->Unit(benchmark::kMillisecond);
+
+	benchmark::RegisterBenchmark("raster/long_line/antialiased", benchmarkRasterLongLine);
+
+	for (int k = SPAN_SCALAR; k <= SPAN_AVX2; k++)
+	{
+		std::string name = spanKernelName(span_kernel(k));
+		benchmark::RegisterBenchmark(("raster/8k_rectangles/" + name).c_str(), benchmarkRasterRectangles, span_kernel(k))->Unit(benchmark::kMillisecond);
+		benchmark::RegisterBenchmark(("raster/8k_clear/" + name).c_str(), benchmarkRasterClear, span_kernel(k))->Unit(benchmark::kMillisecond);
+	}
+	for (unsigned threads = 2; threads <= 8; threads *= 2)
+	{
+		benchmark::RegisterBenchmark(("raster/8k_rectangles_tiled/" + std::to_string(threads)).c_str(), benchmarkRasterTiled, threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	registerBenchmarks();
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,660 @@
+#include "parser.hpp"
+
+/*
+Compiles the statements of a starting statement into a new chunk
+*/
+Chunk * Compiler::compileStartingStatement(std::vector<Statement*> & statements)
+{
+	Chunk * chunk = new Chunk();
+	Compiler c(chunk, false);
+	for (std::vector<Statement*>::iterator i = statements.begin(); i != statements.end(); i++)
+	{
+		(*i)->compile(&c);
+
+		for (std::vector<int>::iterator j = c.pending_outputs.begin(); j != c.pending_outputs.end(); j++)
+		{
+			c.patch(*j, c.here());
+		}
+		c.pending_outputs.clear();
+	}
+	c.emit(OP_HALT);
+	return chunk;
+}
+
+/*
+Compiles the body of a function into a new chunk, its parameters taking the first slots of the frame
+*/
+Chunk * Compiler::compileFunction(Span<SymbolId> arguments, Span<InFunctionStatement*> statements)
+{
+	Chunk * chunk = new Chunk();
+	Compiler c(chunk, true);
+	for (SymbolId * i = arguments.begin(); i != arguments.end(); i++)
+	{
+		chunk->parameters.push_back(c.addLocalSlot(*i));
+	}
+	c.emitBody(statements);
+	c.emit(OP_RETURN);
+	return chunk;
+}
+
+/*
+Appends an instruction without operands
+*/
+void Compiler::emit(int op)
+{
+	chunk->code.push_back(op);
+}
+
+/*
+Appends an instruction with one operand
+*/
+void Compiler::emit(int op, int a)
+{
+	chunk->code.push_back(op);
+	chunk->code.push_back(a);
+}
+
+/*
+Appends an instruction with two operands
+*/
+void Compiler::emit(int op, int a, int b)
+{
+	chunk->code.push_back(op);
+	chunk->code.push_back(a);
+	chunk->code.push_back(b);
+}
+
+/*
+Records the position in the source of the next instruction emitted, for the errors it may raise
+*/
+void Compiler::mark(const position & p)
+{
+	chunk->positions.push_back({ here(), p });
+}
+
+/*
+Returns the position in the source of the instruction being executed when the instruction pointer
+has moved past its opcode to the given offset
+*/
+position Chunk::positionAt(int offset) const
+{
+	position p = { -1, -1, -1 };
+	for (std::vector<code_position>::const_iterator i = positions.begin(); i != positions.end() && i->offset < offset; i++)
+	{
+		p = i->pos;
+	}
+	return p;
+}
+
+/*
+Returns the index of the next instruction to be emitted
+*/
+int Compiler::here()
+{
+	return int(chunk->code.size());
+}
+
+/*
+Sets the jump target stored at the given index of the code
+*/
+void Compiler::patch(int operand, int target)
+{
+	chunk->code[size_t(operand)] = target;
+}
+
+/*
+Returns the slot of a variable in the frame of the function, adding a slot if needed
+*/
+int Compiler::addLocalSlot(SymbolId name)
+{
+	int slot = findLocalSlot(name);
+	if (slot >= 0) return slot;
+	chunk->locals.push_back(name);
+	return int(chunk->locals.size() - 1);
+}
+
+/*
+Returns the slot of a variable in the frame of the function, -1 if it has none
+*/
+int Compiler::findLocalSlot(SymbolId name)
+{
+	for (size_t i = 0; i < chunk->locals.size(); i++)
+	{
+		if (chunk->locals[i] == name) return int(i);
+	}
+	return -1;
+}
+
+/*
+Returns the index of a new string constant in the chunk
+*/
+int Compiler::addString(std::string s)
+{
+	chunk->strings.push_back(s);
+	return int(chunk->strings.size() - 1);
+}
+
+/*
+Returns the index of a new function definition in the chunk
+*/
+int Compiler::addFunction(FunctionDefinition * f)
+{
+	chunk->functions.push_back(f);
+	return int(chunk->functions.size() - 1);
+}
+
+/*
+Reserves a counter for a repeat statement nested at the current depth
+*/
+int Compiler::acquireLoopSlot()
+{
+	int slot = loop_depth++;
+	if (loop_depth > chunk->loop_slots) chunk->loop_slots = loop_depth;
+	return slot;
+}
+
+/*
+Frees the counter of the innermost repeat statement
+*/
+void Compiler::releaseLoopSlot()
+{
+	loop_depth--;
+}
+
+/*
+Emits an instruction leaving the current function, or the current top level statement outside of functions
+*/
+void Compiler::emitOutput(int op)
+{
+	if (in_function)
+	{
+		emit(op, -1);
+	}
+	else
+	{
+		emit(op, 0);
+		pending_outputs.push_back(here() - 1);
+	}
+}
+
+/*
+Emits the statements of a function, an if or a repeat body
+*/
+void Compiler::emitBody(Span<InFunctionStatement*> statements)
+{
+	for (InFunctionStatement ** i = statements.begin(); i != statements.end(); i++)
+	{
+		if (*i != nullptr) (*i)->compile(this);
+	}
+}
+
+/*
+Compiles all statements of the starting statement
+*/
+Chunk * StartingStatement::compile()
+{
+	return Compiler::compileStartingStatement(statementList);
+}
+
+/*
+Returns the bytecode of the function body, compiling it on first use
+*/
+Chunk * FunctionDefinition::getChunk()
+{
+	if (chunk == nullptr) chunk = Compiler::compileFunction(arguments, statementList);
+	return chunk;
+}
+
+/*
+Compiles a function definition
+*/
+void FunctionDefinition::compile(Compiler * c)
+{
+	c->emit(OP_DEFINE, c->addFunction(this));
+}
+
+/*
+Compiles a variable read, from the frame of the function if the variable has a slot there
+*/
+void Variable::compile(Compiler * c)
+{
+	int slot = c->inFunction() ? c->findLocalSlot(identifier.integer_value) : -1;
+	c->mark(identifier.pos);
+	if (slot >= 0)
+	{
+		c->emit(OP_LOAD_LOCAL, slot);
+	}
+	else
+	{
+		c->emit(OP_LOAD_GLOBAL, identifier.integer_value);
+	}
+}
+
+/*
+Compiles a function call used as a statement; a call in tail position of a function body may reuse its frame
+*/
+void Function::compile(Compiler * c)
+{
+	for (AdditiveExpression ** i = argument_list.begin(); i != argument_list.end(); i++)
+	{
+		(*i)->compile(c);
+	}
+	c->mark(identifier.pos);
+	c->emit(tail_call && c->inFunction() ? OP_TAIL_CALL : OP_CALL_STATEMENT, identifier.integer_value, int(argument_list.size()));
+	c->emitOutput(OP_PROPAGATE);
+}
+
+/*
+Compiles a function call used in an expression
+*/
+void Function::compileExpression(Compiler * c)
+{
+	for (AdditiveExpression ** i = argument_list.begin(); i != argument_list.end(); i++)
+	{
+		(*i)->compile(c);
+	}
+	c->mark(identifier.pos);
+	c->emit(OP_CALL, identifier.integer_value, int(argument_list.size()));
+}
+
+/*
+Compiles a flattened product: pushes every operand from left to right, then applies the operators from the right
+*/
+static void compileFactors(Compiler * c, const Span<expression_factor> & factors)
+{
+	for (expression_factor * f = factors.begin(); f != factors.end(); f++)
+	{
+		switch (f->type)
+		{
+		case MultiplicativeExpression::M_NUMBER:
+			c->emit(OP_PUSH, f->number);
+			break;
+		case MultiplicativeExpression::M_VARIABLE:
+			f->variable->compile(c);
+			break;
+		case MultiplicativeExpression::M_FUNCTION:
+			f->function->compileExpression(c);
+			break;
+		case MultiplicativeExpression::M_PARENTHESIS:
+			f->additive_expression_in_parentheses->compile(c);
+			break;
+		}
+	}
+
+	for (size_t i = factors.size() - 1; i > 0; i--)
+	{
+		if (factors[i - 1].op == '*')
+		{
+			c->emit(OP_MUL);
+			continue;
+		}
+		c->mark(factors[i - 1].op_position);
+		c->emit(OP_DIV);
+	}
+}
+
+/*
+Compiles an additive expression from its flattened form, a constant expression being a single push
+*/
+void AdditiveExpression::compile(Compiler * c)
+{
+	for (expression_term * t = terms.begin(); t != terms.end(); t++)
+	{
+		compileFactors(c, t->factors);
+
+		if (t->coefficient == -1)
+		{
+			c->emit(t == terms.begin() ? OP_NEG : OP_SUB);
+			continue;
+		}
+		if (t->coefficient != 1)
+		{
+			c->emit(OP_PUSH, t->coefficient);
+			c->emit(OP_MUL);
+		}
+		if (t != terms.begin())
+		{
+			c->emit(OP_ADD);
+		}
+	}
+
+	if (terms.empty())
+	{
+		c->emit(OP_PUSH, constant);
+	}
+	else if (constant != 0)
+	{
+		c->emit(OP_PUSH, constant);
+		c->emit(OP_ADD);
+	}
+}
+
+/*
+Compiles a logical expression
+*/
+void LogicalExpression::compile(Compiler * c)
+{
+	switch (logical_type)
+	{
+	case L_BASE_LOGICAL_VALUE:
+		c->emit(OP_PUSH, logical_value ? 1 : 0);
+		break;
+	case L_COMPARISON:
+		first_operand->compile(c);
+		last_operand->compile(c);
+		switch (binary_operator.integer_value)
+		{
+		case '<':
+			c->emit(OP_LT);
+			break;
+		case '>':
+			c->emit(OP_GT);
+			break;
+		case '=':
+			c->emit(OP_EQ);
+			break;
+		default:
+			c->emit(OP_NE);
+		}
+		break;
+	case L_UNARY:
+		logical_expression_set->compile(c);
+		c->emit(OP_NOT);
+		break;
+	case L_BRACES:
+		logical_expression_set->compile(c);
+		break;
+	}
+}
+
+/*
+Compiles a set of logical expressions, short-circuiting and / or
+*/
+void LogicalExpressionSet::compile(Compiler * c)
+{
+	first_operand->compile(c);
+	if (!has_last_operand) return;
+
+	if (binary_operator.integer_value == K_XOR)
+	{
+		last_operand->compile(c);
+		c->emit(OP_NE);
+		return;
+	}
+
+	bool is_and = binary_operator.integer_value == K_AND;
+	c->emit(is_and ? OP_JMP_FALSE : OP_JMP_TRUE, 0);
+	int short_circuit = c->here() - 1;
+	last_operand->compile(c);
+	c->emit(OP_JMP, 0);
+	int done = c->here() - 1;
+	c->patch(short_circuit, c->here());
+	c->emit(OP_PUSH, is_and ? 0 : 1);
+	c->patch(done, c->here());
+}
+
+/*
+Compiles a forward statement
+*/
+void Forward::compile(Compiler * c)
+{
+	move_by_value->compile(c);
+	c->emit(OP_FORWARD);
+}
+
+/*
+Compiles a backward statement
+*/
+void Backward::compile(Compiler * c)
+{
+	move_by_value->compile(c);
+	c->emit(OP_BACKWARD);
+}
+
+/*
+Compiles a right turn statement
+*/
+void RightTurn::compile(Compiler * c)
+{
+	move_by_value->compile(c);
+	c->emit(OP_RIGHT);
+}
+
+/*
+Compiles a left turn statement
+*/
+void LeftTurn::compile(Compiler * c)
+{
+	move_by_value->compile(c);
+	c->emit(OP_LEFT);
+}
+
+/*
+Compiles a move by vector statement
+*/
+void MoveByVector::compile(Compiler * c)
+{
+	x_value->compile(c);
+	y_value->compile(c);
+	c->emit(OP_MOVE_BY);
+}
+
+/*
+Compiles a move to position statement
+*/
+void MoveToPosition::compile(Compiler * c)
+{
+	x_value->compile(c);
+	y_value->compile(c);
+	c->emit(OP_MOVE_TO);
+}
+
+/*
+Compiles a set heading statement
+*/
+void SetHeading::compile(Compiler * c)
+{
+	heading_value->compile(c);
+	c->emit(OP_SET_HEADING);
+}
+
+/*
+Compiles a turtle go home statement
+*/
+void TurtleGoHome::compile(Compiler * c)
+{
+	c->emit(OP_HOME);
+}
+
+/*
+Compiles a get x statement
+*/
+void GetX::compile(Compiler * c)
+{
+	c->emit(OP_GETX);
+	c->emit(OP_SET_RESULT);
+}
+
+/*
+Compiles a get x expression
+*/
+void GetX::compileExpression(Compiler * c)
+{
+	c->emit(OP_GETX);
+}
+
+/*
+Compiles a get y statement
+*/
+void GetY::compile(Compiler * c)
+{
+	c->emit(OP_GETY);
+	c->emit(OP_SET_RESULT);
+}
+
+/*
+Compiles a get y expression
+*/
+void GetY::compileExpression(Compiler * c)
+{
+	c->emit(OP_GETY);
+}
+
+/*
+Compiles a get heading statement
+*/
+void GetHeading::compile(Compiler * c)
+{
+	c->emit(OP_GETHEADING);
+	c->emit(OP_SET_RESULT);
+}
+
+/*
+Compiles a get heading expression
+*/
+void GetHeading::compileExpression(Compiler * c)
+{
+	c->emit(OP_GETHEADING);
+}
+
+/*
+Compiles a clear screen statement
+*/
+void CleanScreen::compile(Compiler * c)
+{
+	c->emit(OP_CLEAR);
+}
+
+/*
+Compiles a pen up statement
+*/
+void PenUp::compile(Compiler * c)
+{
+	c->emit(OP_PEN_UP);
+}
+
+/*
+Compiles a pen down statement
+*/
+void PenDown::compile(Compiler * c)
+{
+	c->emit(OP_PEN_DOWN);
+}
+
+/*
+Compiles a set color statement
+*/
+void SetColor::compile(Compiler * c)
+{
+	red->compile(c);
+	green->compile(c);
+	blue->compile(c);
+	c->emit(OP_SET_COLOR);
+}
+
+/*
+Compiles an output statement
+*/
+void Output::compile(Compiler * c)
+{
+	additive_exp->compile(c);
+	c->emitOutput(OP_OUTPUT);
+}
+
+/*
+Compiles a print statement
+*/
+void Print::compile(Compiler * c)
+{
+	if (is_string)
+	{
+		c->emit(OP_PRINT_STRING, c->addString(string_exp));
+	}
+	else
+	{
+		additive_exp->compile(c);
+		c->emit(OP_PRINT);
+	}
+}
+
+/*
+Compiles a scan statement
+*/
+void Scan::compile(Compiler * c)
+{
+	c->emit(OP_SCAN, identifier.integer_value);
+}
+
+/*
+Compiles a make statement
+*/
+void Make::compile(Compiler * c)
+{
+	assigned_value->compile(c);
+	c->emit(OP_MAKE, identifier.integer_value);
+}
+
+/*
+Compiles a local make / scan statement, which outside of a function defines a global variable
+*/
+void LocalMakeScan::compile(Compiler * c)
+{
+	if (isScan)
+	{
+		c->emit(OP_LOCAL_SCAN, identifier.integer_value);
+	}
+	else if (c->inFunction())
+	{
+		assigned_value->compile(c);
+		c->emit(OP_LOCAL_MAKE, c->addLocalSlot(identifier.integer_value));
+	}
+	else
+	{
+		assigned_value->compile(c);
+		c->emit(OP_MAKE, identifier.integer_value);
+	}
+}
+
+/*
+Compiles an if statement
+*/
+void IfStatement::compile(Compiler * c)
+{
+	c->emit(OP_CLEAR_RESULT);
+	condition->compile(c);
+	c->emit(OP_JMP_FALSE, 0);
+	int done = c->here() - 1;
+	c->emitBody(statementList);
+	c->patch(done, c->here());
+}
+
+/*
+Compiles a repeat statement, the number of repetitions is evaluated before every repetition
+*/
+void RepeatStatement::compile(Compiler * c)
+{
+	c->emit(OP_CLEAR_RESULT);
+	if (statementList.empty()) return;
+
+	int slot = c->acquireLoopSlot();
+	c->emit(OP_LOOP_INIT, slot);
+	int head = c->here();
+	number_of_repetitions->compile(c);
+	c->emit(OP_LOOP_TEST, slot, 0);
+	int done = c->here() - 1;
+	c->emitBody(statementList);
+	c->mark(pos);
+	c->emit(OP_LOOP_NEXT, slot, head);
+	c->patch(done, c->here());
+	c->releaseLoopSlot();
+}
+
+/*
+Compiles a turtle sleep statement
+*/
+void TurtleSleep::compile(Compiler * c)
+{
+	time_to_sleep->compile(c);
+	c->mark(pos);
+	c->emit(OP_SLEEP);
+}
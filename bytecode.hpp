@@ -0,0 +1,142 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#pragma once
+#include <string>
+#include <vector>
+#include <list>
+#include "symbol.hpp"
+#include "arena.hpp"
+#include "source.hpp"
+
+/*
+Instructions of the virtual machine; operands follow the instruction in the code
+*/
+enum op_code
+{
+	OP_PUSH,			/* value: pushes a constant */
+	OP_LOAD_GLOBAL,		/* symbol: pushes the value of a variable not local to the function */
+	OP_LOAD_LOCAL,		/* slot: pushes the value of a variable in the frame of the function */
+	OP_NEG,
+	OP_ADD,
+	OP_SUB,
+	OP_MUL,
+	OP_DIV,
+	OP_LT,
+	OP_GT,
+	OP_EQ,
+	OP_NE,
+	OP_NOT,
+	OP_JMP,				/* target */
+	OP_JMP_FALSE,		/* target: pops the condition */
+	OP_JMP_TRUE,		/* target: pops the condition */
+	OP_GETX,
+	OP_GETY,
+	OP_GETHEADING,
+	OP_FORWARD,
+	OP_BACKWARD,
+	OP_RIGHT,
+	OP_LEFT,
+	OP_MOVE_BY,
+	OP_MOVE_TO,
+	OP_SET_HEADING,
+	OP_HOME,
+	OP_CLEAR,
+	OP_PEN_UP,
+	OP_PEN_DOWN,
+	OP_SET_COLOR,
+	OP_PRINT,
+	OP_PRINT_STRING,	/* string */
+	OP_SCAN,			/* symbol */
+	OP_MAKE,			/* symbol */
+	OP_LOCAL_MAKE,		/* slot */
+	OP_LOCAL_SCAN,		/* symbol */
+	OP_SLEEP,
+	OP_DEFINE,			/* function definition */
+	OP_CLEAR_RESULT,
+	OP_SET_RESULT,
+	OP_LOOP_INIT,		/* loop slot */
+	OP_LOOP_TEST,		/* loop slot, target: pops the number of repetitions */
+	OP_LOOP_NEXT,		/* loop slot, target */
+	OP_CALL,			/* symbol, number of arguments: the result is pushed */
+	OP_CALL_STATEMENT,	/* symbol, number of arguments: the result becomes the statement result */
+	OP_TAIL_CALL,		/* symbol, number of arguments: a statement call ending the function, which replaces its frame when it can */
+	OP_OUTPUT,			/* target, -1 returns from the function */
+	OP_PROPAGATE,		/* target, -1 returns from the function: outputs the result of a called function if it was an output */
+	OP_RETURN,
+	OP_HALT,
+	OP_COUNT
+};
+
+class FunctionDefinition;
+class Statement;
+class InFunctionStatement;
+class Token;
+
+/*
+Linear bytecode of a starting statement or of the body of a function, together with the layout
+of the frame of the function (the variable held by each slot, and the slot of each parameter)
+and the positions in the source of the instructions which can raise an error
+*/
+class Chunk
+{
+public:
+	/*
+	Position in the source of the instructions from the given offset of the code on
+	*/
+	struct code_position
+	{
+		int offset;
+		position pos;
+	};
+
+	Chunk() = default;
+	position positionAt(int offset) const;
+
+	std::vector<int> code;
+	std::vector<std::string> strings;
+	std::vector<FunctionDefinition*> functions;
+	std::vector<SymbolId> locals;
+	std::vector<int> parameters;
+	std::vector<code_position> positions;
+	int loop_slots = 0;
+};
+
+/*
+Translates the syntax tree built by the parser into a chunk of bytecode
+*/
+class Compiler
+{
+public:
+	Compiler(Chunk * c, bool f) : chunk(c), in_function(f) {}
+
+	static Chunk * compileStartingStatement(std::vector<Statement*> & statements);
+	static Chunk * compileFunction(Span<SymbolId> arguments, Span<InFunctionStatement*> statements);
+
+	void emit(int op);
+	void emit(int op, int a);
+	void emit(int op, int a, int b);
+	void mark(const position & p);
+	int here();
+	void patch(int operand, int target);
+
+	int addLocalSlot(SymbolId name);
+	int findLocalSlot(SymbolId name);
+	bool inFunction() { return in_function; }
+	int addString(std::string s);
+	int addFunction(FunctionDefinition * f);
+
+	int acquireLoopSlot();
+	void releaseLoopSlot();
+
+	void emitOutput(int op);
+	void emitBody(Span<InFunctionStatement*> statements);
+
+private:
+	Chunk * chunk;
+	bool in_function;
+	int loop_depth = 0;
+	std::vector<int> pending_outputs;
+};
+
+#endif
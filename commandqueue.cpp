@@ -0,0 +1,75 @@
+#include "commandqueue.hpp"
+#include <algorithm>
+#include <thread>
+#include <chrono>
+
+/*
+Constructor; the capacity is rounded up to a power of two
+*/
+CommandQueue::CommandQueue(size_t capacity)
+{
+	size_t size = 1;
+	while (size < capacity) size <<= 1;
+	ring.resize(size);
+	mask = size - 1;
+}
+
+/*
+Appends as many of the calls as there is room for, called by the producer only; returns the number appended
+*/
+size_t CommandQueue::push(const render_command * first, size_t count)
+{
+	size_t t = tail.load(std::memory_order_relaxed);
+	if (ring.size() - (t - cached_head) < count) cached_head = head.load(std::memory_order_acquire);
+	count = std::min(count, ring.size() - (t - cached_head));
+
+	for (size_t i = 0; i < count; i++)
+	{
+		ring[(t + i) & mask] = first[i];
+	}
+	tail.store(t + count, std::memory_order_release);
+	return count;
+}
+
+/*
+Takes up to max calls from the front of the queue, called by the consumer only; returns the number taken
+*/
+size_t CommandQueue::pop(render_command * out, size_t max)
+{
+	size_t h = head.load(std::memory_order_relaxed);
+	if (cached_tail - h < max) cached_tail = tail.load(std::memory_order_acquire);
+	size_t count = std::min(max, cached_tail - h);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = ring[(h + i) & mask];
+	}
+	head.store(h + count, std::memory_order_release);
+	return count;
+}
+
+/*
+Publishes a batch of calls, waiting for the consumer to make room when the queue is full
+*/
+void QueueSink::drawCommands(const render_command * first, size_t count)
+{
+	int waits = 0;
+	while (count > 0)
+	{
+		size_t pushed = queue->push(first, count);
+		first += pushed;
+		count -= pushed;
+		if (pushed != 0)
+		{
+			waits = 0;
+		}
+		else if (++waits < 64)
+		{
+			std::this_thread::yield();
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef COMMANDQUEUE_H
+#define COMMANDQUEUE_H
+
+#pragma once
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include "rendersink.hpp"
+
+/*
+Bounded ring of drawing calls passed from one producer thread to one consumer thread without locks; each side
+writes only its own index and keeps a copy of the other one, read again only when the ring looks full or empty
+*/
+class CommandQueue
+{
+public:
+	explicit CommandQueue(size_t capacity = 1 << 16);
+	CommandQueue(const CommandQueue &) = delete;
+	CommandQueue & operator=(const CommandQueue &) = delete;
+
+	size_t push(const render_command * first, size_t count);
+	size_t pop(render_command * out, size_t max);
+	bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+private:
+	std::vector<render_command> ring;
+	size_t mask;
+
+	alignas(64) std::atomic<size_t> tail{ 0 };
+	size_t cached_head = 0;
+
+	alignas(64) std::atomic<size_t> head{ 0 };
+	size_t cached_tail = 0;
+};
+
+/*
+Render sink of the interpreter thread, publishing the drawing calls to a CommandQueue drained by the thread of the view;
+it waits while the queue is full and forwards the requests for input to the given sink
+*/
+class QueueSink : public RenderSink
+{
+public:
+	QueueSink(CommandQueue * q, RenderSink * i) : queue(q), input(i) {}
+	void drawLine2Point(int x1, int y1, int x2, int y2) { publish({ RC_LINE, x1, y1, x2, y2 }); }
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle) { publish({ RC_LINE_POLAR, x1, y1, length, angle }); }
+	void moveTurtle2Point(int x2, int y2) { publish({ RC_MOVE, x2, y2, 0, 0 }); }
+	void moveTurtlePointAngleLength(int x1, int y1, int length, int angle) { publish({ RC_MOVE_POLAR, x1, y1, length, angle }); }
+	void clearScreen() { publish({ RC_CLEAR, 0, 0, 0, 0 }); }
+	void updateColor(int r, int g, int b) { publish({ RC_COLOR, r, g, b, 0 }); }
+	int getValueFromUser(std::string s) { return input->getValueFromUser(s); }
+	void drawCommands(const render_command * first, size_t count);
+
+private:
+	void publish(const render_command & c) { drawCommands(&c, 1); }
+
+	CommandQueue * queue;
+	RenderSink * input;
+};
+
+#endif
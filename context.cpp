@@ -1,427 +1,528 @@
-#include "model.hpp"
-#include "context.hpp"
-#include "parser.hpp"
-#define HOME_X 250
-#define HOME_Y 250
-#define HOME_HEADING 900
-
-/*
-Adds a variable globally
-*/
-void VariableSymbolTableStack::addVariable(std::string name, int value)
-{
-	if (existsVariable(name))
-	{
-		variable_table::iterator i = v.front()->find(name);
-		i->second = value;
-	}
-	else
-	{
-		v.front()->insert({ name, value });
-	}
-
-}
-
-/*
-Adds a variable locally
-*/
-void VariableSymbolTableStack::addLocalVariable(std::string name, int value)
-{
-	if (existsLocalVariable(name))
-	{
-		variable_table::iterator i = v.back()->find(name);
-		i->second = value;
-	}
-	else
-	{
-		v.back()->insert({ name, value });
-	}
-}
-
-/*
-Adds a new variable table to stack
-*/
-void VariableSymbolTableStack::pushVariableTable()
-{
-	variable_table * t = new variable_table();
-	v.push_back(t);
-
-}
-
-/*
-Removes last added variable table from stack
-*/
-void VariableSymbolTableStack::popVariableTable()
-{
-	delete v.back();
-	v.pop_back();
-}
-
-/*
-Checks whether given variable exists (global scope)
-*/
-bool VariableSymbolTableStack::existsVariable(std::string name)
-{
-	variable_table :: iterator i = v.front()->find(name);
-
-	if (i == v.front()->end())
-	{
-		return false;
-	}
-
-	return true;
-}
-
-/*
-Checks whether given variable exists (local scope)
-*/
-bool VariableSymbolTableStack::existsLocalVariable(std::string name)
-{
-	variable_table::iterator i = v.back()->find(name);
-
-	if (i == v.back()->end())
-	{
-		return false;
-	}
-
-	return true;
-}
-
-/*
-Searches for a variable from the top of the call stack
-*/
-int VariableSymbolTableStack::getVariable(std::string name)
-{
-	for (std::list<variable_table*>::reverse_iterator i = v.rbegin(); i != v.rend(); i++)
-	{
-		variable_table::iterator j = (*i)->find(name);
-		if (j != (*i)->end()) return j->second;
-	}
-
-	throw "Nonexistent variable!\n";
-}
-
-/*
-Adds a function to the function list
-*/
-FunctionDefinition * FunctionSymbolTable::addFunction(FunctionDefinition * f, std::string name)
-{
-	FunctionDefinition * f_prev = tab[name];
-	tab[name] = f;
-	return f_prev;
-}
-
-/*
-Searches for a function in the function list
-*/
-FunctionDefinition * FunctionSymbolTable::getFunction(std::string name)
-{
-	function_table::iterator i = tab.find(name);
-	if (i == tab.end())
-	{
-		return nullptr;
-	}
-	return i->second;
-}
-
-/*
-Checks whether given function exists
-*/
-bool FunctionSymbolTable::existsFunction(std::string name)
-{
-	function_table::iterator i = tab.find(name);
-	if (i == tab.end())
-	{
-		return false;
-	}
-	return true;
-}
-
-/*
-Restores the given function table to what it currently holds
-*/
-void FunctionSymbolTable::restoreFunctionSymbolTable(FunctionSymbolTable * fun)
-{
-    if(this->tab.empty()) return;
-    function_table::iterator i = fun->tab.begin();
-    while(i != fun->tab.end())
-    {
-        FunctionDefinition * fundef = this->getFunction(i->first);
-        if(fundef == nullptr)
-        {
-            fun->removeFunction(i->first);
-            i = fun->tab.begin();
-        }
-        else
-        {
-            fun->addFunction(fundef, i->first);
-            i++;
-        }
-    }
-}
-
-/*
-Removes the function with a given name from the function table
-*/
-void FunctionSymbolTable::removeFunction(std::string name)
-{
-    function_table::iterator i = tab.find(name);
-    tab.erase(i);
-}
-
-/*
-Adds a function to the function list
-*/
-void ProgramContext::addFunction(FunctionDefinition * f, std::string name)
-{
-	function_table.addFunction(f, name);
-}
-
-/*
-Searches for a function in the function list
-*/
-FunctionDefinition * ProgramContext::getFunction(std::string name)
-{
-	return function_table.getFunction(name);
-}
-
-/*
-Restores the function table to what it currently holds
-*/
-void ProgramContext::restoreFunctionSymbolTable(FunctionSymbolTable * fun)
-{
-    function_table.restoreFunctionSymbolTable(fun);
-}
-
-/*
-Searches for a variable from the top of the call stack
-*/
-int ProgramContext::getVariable(std::string name)
-{
-	int i = variable_table_stack.getVariable(name);
-	return i;
-}
-
-/*
-Adds a variable globally
-*/
-void ProgramContext::addVariable(std::string name, int value)
-{
-	variable_table_stack.addVariable(name, value);
-}
-
-/*
-Adds a variable locally
-*/
-void ProgramContext::addLocalVariable(std::string name, int value)
-{
-	variable_table_stack.addLocalVariable(name, value);
-}
-
-/*
-Adds a new context for a function call
-*/
-void ProgramContext::pushContext()
-{
-	variable_table_stack.pushVariableTable();
-}
-
-/*
-Removes last added context for a function call
-*/
-void ProgramContext::popContext()
-{
-	variable_table_stack.popVariableTable();
-}
-
-/*
-Initializes the turtle-describing variables
-*/
-void ProgramContext::turtleInit()
-{
-    x = HOME_X;
-    y = HOME_Y;
-    heading = HOME_HEADING;
-    pen_is_up = false;
-    red = 0;
-    green = 0;
-    blue = 0;
-}
-
-/*
-Moves the turtle forward by lenght (or backward, if negative)
-*/
-void ProgramContext::move_forward(int length)
-{
-
-    if(pen_is_up)
-    {
-        model->moveTurtlePointAngleLength(this->x, this->y, length, heading);
-    }
-    else
-    {
-        model->drawLinePointAngleLength(this->x, this->y, length, heading);
-    }
-}
-
-/*
-Turns the turtle by angle tenths of a degree
-*/
-void ProgramContext::turn_by(int angle)
-{
-    heading += angle;
-    heading %= 3600;
-}
-
-/*
-Sets turtle's heading
-*/
-void ProgramContext::set_heading(int angle)
-{
-    heading = angle;
-}
-
-/*
-Moves the turtle to the specified point
-*/
-void ProgramContext::move_to(int x, int y)
-{
-    if(pen_is_up)
-    {
-        model->moveTurtle2Point(x, y);
-    }
-    else
-    {
-        model->drawLine2Point(this->x, this->y, x, y);
-    }
-}
-
-/*
-Moves the turtle by a specified vector
-*/
-void ProgramContext::move_by(int x, int y)
-{
-    if(pen_is_up)
-    {
-        model->moveTurtle2Point(this->x + x, this->y + y);
-    }
-    else
-    {
-        model->drawLine2Point(this->x, this->y, this->x + x, this->y + y);
-    }
-}
-
-/*
-Lifts the pen
-*/
-void ProgramContext::pen_up()
-{
-    pen_is_up = true;
-}
-
-/*
-Lowers the pen
-*/
-void ProgramContext::pen_down()
-{
-    pen_is_up = false;
-}
-
-/*
-Clears the screen
-*/
-void ProgramContext::clear_screen()
-{
-    model->clearScreen();
-}
-
-/*
-Moves the turtle back to the middle of the screen
-*/
-void ProgramContext::go_home()
-{
-    move_to(HOME_X, HOME_Y);
-    heading = HOME_HEADING;
-}
-
-/*
-Sets the color of the pen
-*/
-void ProgramContext::set_color(int r, int g, int b)
-{
-    red = r;
-    green = g;
-    blue = b;
-    model->updateColor(r, g, b);
-}
-
-/*
-Returns current x
-*/
-int ProgramContext::getx()
-{
-    return x;
-}
-
-/*
-Returns current y
-*/
-int ProgramContext::gety()
-{
-    return y;
-}
-
-/*
-Returns current heading
-*/
-int ProgramContext::geth()
-{
-    return heading;
-}
-
-/*
-Writes to log
-*/
-void ProgramContext::writeToLog(std::string s)
-{
-    output_log += s;
-}
-
-/*
-Reads from log and clears it
-*/
-std::string ProgramContext::readFromLog()
-{
-    std::string s = std::string(output_log);
-    output_log = "";
-    return s;
-}
-
-/*
-Writes to error log
-*/
-void ProgramContext::writeToErrorLog(std::string s)
-{
-    error_log += s;
-}
-
-/*
-Reads from error log and clears it
-*/
-std::string ProgramContext::readFromErrorLog()
-{
-    std::string s = std::string(error_log);
-    error_log = "";
-    return s;
-}
-
-/*
-Gets a value from user
-*/
-int ProgramContext::getValueFromUser(std::string s)
-{
-    return model->getValueFromUser(s);
-}
-
-
-
+#include "model.hpp"
+#include "context.hpp"
+#include "parser.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#define HOME_X 250
+#define HOME_Y 250
+#define HOME_HEADING 900
+
+/*
+Makes room for a variable in the global arrays
+*/
+void VariableSymbolTableStack::reserve(SymbolId name)
+{
+	if (size_t(name) < shadow_count.size()) return;
+	size_t size = size_t(SymbolTable::instance().size());
+	if (size <= size_t(name)) size = size_t(name) + 1;
+	global_values.resize(size, 0);
+	global_defined.resize(size, false);
+	shadow_count.resize(size, 0);
+}
+
+/*
+Adds a variable globally
+*/
+void VariableSymbolTableStack::addVariable(SymbolId name, int value)
+{
+	reserve(name);
+	global_values[size_t(name)] = value;
+	global_defined[size_t(name)] = true;
+}
+
+/*
+Adds a variable locally, or globally outside of any function call
+*/
+void VariableSymbolTableStack::addLocalVariable(SymbolId name, int value)
+{
+	if (frame_base.empty())
+	{
+		addVariable(name, value);
+		return;
+	}
+
+	for (size_t i = frame_base.back(); i < locals.size(); i++)
+	{
+		if (locals[i].name == name)
+		{
+			setLocalVariable(int(i - frame_base.back()), value);
+			return;
+		}
+	}
+
+	reserve(name);
+	locals.push_back({ name, value, true });
+	shadow_count[size_t(name)]++;
+}
+
+/*
+Sets a slot of the current frame
+*/
+void VariableSymbolTableStack::setLocalVariable(int slot, int value)
+{
+	variable_slot & v = locals[frame_base.back() + size_t(slot)];
+	if (!v.defined)
+	{
+		reserve(v.name);
+		v.defined = true;
+		shadow_count[size_t(v.name)]++;
+	}
+	v.value = value;
+}
+
+/*
+Adds a new, empty frame to the stack
+*/
+void VariableSymbolTableStack::pushVariableTable()
+{
+	frame_base.push_back(locals.size());
+}
+
+/*
+Adds a new frame with the given names in its slots, none of them defined yet
+*/
+void VariableSymbolTableStack::pushVariableTable(const std::vector<SymbolId> & layout)
+{
+	frame_base.push_back(locals.size());
+	for (std::vector<SymbolId>::const_iterator i = layout.begin(); i != layout.end(); i++)
+	{
+		locals.push_back({ *i, 0, false });
+	}
+}
+
+/*
+Removes last added frame from stack
+*/
+void VariableSymbolTableStack::popVariableTable()
+{
+	for (size_t i = frame_base.back(); i < locals.size(); i++)
+	{
+		if (locals[i].defined) shadow_count[size_t(locals[i].name)]--;
+	}
+	locals.resize(frame_base.back());
+	frame_base.pop_back();
+}
+
+/*
+Checks if every variable defined by the last frame is among the given names, so that a frame defining all
+of them would hide the last one from any lookup and the last frame could be dropped
+*/
+bool VariableSymbolTableStack::isFrameShadowedBy(const SymbolId * names, size_t count)
+{
+	for (size_t i = frame_base.back(); i < locals.size(); i++)
+	{
+		if (locals[i].defined && std::find(names, names + count, locals[i].name) == names + count) return false;
+	}
+	return true;
+}
+
+/*
+Searches for a variable from the top of the call stack, then among the globals
+*/
+bool VariableSymbolTableStack::lookupInFrames(SymbolId name, int & value)
+{
+	for (size_t i = locals.size(); i > 0; i--)
+	{
+		if (locals[i - 1].name == name && locals[i - 1].defined)
+		{
+			value = locals[i - 1].value;
+			return true;
+		}
+	}
+
+	if (!global_defined[size_t(name)]) return false;
+	value = global_values[size_t(name)];
+	return true;
+}
+
+/*
+Adds a function to the function list
+*/
+FunctionDefinition * FunctionSymbolTable::addFunction(FunctionDefinition * f, SymbolId name)
+{
+	if (size_t(name) >= tab.size()) tab.resize(size_t(name) + 1, nullptr);
+	FunctionDefinition * f_prev = tab[size_t(name)];
+	tab[size_t(name)] = f;
+	return f_prev;
+}
+
+/*
+Restores the given function table to what it currently holds
+*/
+void FunctionSymbolTable::restoreFunctionSymbolTable(FunctionSymbolTable * fun)
+{
+    if(this->tab.empty()) return;
+    for(size_t i = 0; i < fun->tab.size(); i++)
+    {
+        if(fun->tab[i] == nullptr) continue;
+        FunctionDefinition * fundef = this->getFunction(SymbolId(i));
+        if(fundef == nullptr)
+        {
+            fun->removeFunction(SymbolId(i));
+        }
+        else
+        {
+            fun->addFunction(fundef, SymbolId(i));
+        }
+    }
+}
+
+/*
+Removes the function with a given name from the function table
+*/
+void FunctionSymbolTable::removeFunction(SymbolId name)
+{
+    if(size_t(name) < tab.size()) tab[size_t(name)] = nullptr;
+}
+
+/*
+Adds a function to the function list
+*/
+void ProgramContext::addFunction(FunctionDefinition * f, SymbolId name)
+{
+	function_table.addFunction(f, name);
+	function_generation++;
+}
+
+/*
+Restores the function table to what it currently holds
+*/
+void ProgramContext::restoreFunctionSymbolTable(FunctionSymbolTable * fun)
+{
+    function_table.restoreFunctionSymbolTable(fun);
+}
+
+/*
+Adds a variable globally
+*/
+void ProgramContext::addVariable(SymbolId name, int value)
+{
+	variable_table_stack.addVariable(name, value);
+}
+
+/*
+Adds a variable locally
+*/
+void ProgramContext::addLocalVariable(SymbolId name, int value)
+{
+	variable_table_stack.addLocalVariable(name, value);
+}
+
+/*
+Adds a new context for a function call
+*/
+void ProgramContext::pushContext()
+{
+	variable_table_stack.pushVariableTable();
+}
+
+/*
+Removes last added context for a function call
+*/
+void ProgramContext::popContext()
+{
+	variable_table_stack.popVariableTable();
+}
+
+/*
+Starts a function call of the tree walker; returns false if it would go deeper than the maximum call depth
+*/
+bool ProgramContext::enterCall(call_record * c)
+{
+	if (call_depth >= max_call_depth) return false;
+	call_depth++;
+	c->caller = innermost_call;
+	innermost_call = c;
+	return true;
+}
+
+/*
+Ends the innermost function call of the tree walker
+*/
+void ProgramContext::leaveCall()
+{
+	call_depth--;
+	innermost_call = innermost_call->caller;
+}
+
+/*
+Returns an error raised at the given position, with the function calls of the tree walker active at the moment
+*/
+RuntimeError ProgramContext::error(error_code c, position p)
+{
+	RuntimeError e(c, p);
+	for (call_record * i = innermost_call; i != nullptr; i = i->caller)
+	{
+		e.trace.push_back({ i->function, i->call_site });
+	}
+	return e;
+}
+
+/*
+Sleeps for the given time in short slices, waking up early if a stop is requested; returns false if it was
+*/
+bool ProgramContext::sleepFor(int milliseconds)
+{
+	if (model != nullptr) model->flushDrawing();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+	for (;;)
+	{
+		if (isStopRequested()) return false;
+		std::chrono::steady_clock::duration left = end - std::chrono::steady_clock::now();
+		if (left <= std::chrono::steady_clock::duration::zero()) return true;
+		std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(left, std::chrono::milliseconds(10)));
+	}
+}
+
+/*
+Mixes the argument values of a call into a hash
+*/
+size_t argument_hash::operator()(const std::vector<int> & values) const
+{
+	size_t h = values.size();
+	for (std::vector<int>::const_iterator i = values.begin(); i != values.end(); i++)
+	{
+		h ^= size_t(unsigned(*i)) + 0x9e3779b9u + (h << 6) + (h >> 2);
+	}
+	return h;
+}
+
+/*
+Opts a function in to memoization, or out of it dropping its results
+*/
+void ProgramContext::setMemoized(SymbolId name, bool enabled)
+{
+	if (size_t(name) >= memos.size()) memos.resize(size_t(name) + 1);
+	memo_table & m = memos[size_t(name)];
+	m.enabled = enabled;
+	m.generation = -1;
+	m.results.clear();
+}
+
+/*
+Analyses the purity of an opted in function again if a function was defined since the last analysis
+*/
+memo_table * ProgramContext::validateMemo(SymbolId name)
+{
+	memo_table & m = memos[size_t(name)];
+	if (m.generation != function_generation)
+	{
+		FunctionDefinition * f = getFunction(name);
+		m.pure = f != nullptr && f->isPure(this);
+		m.generation = function_generation;
+		m.results.clear();
+	}
+	return m.pure ? &m : nullptr;
+}
+
+/*
+Describes the use of the memo table of every function opted in to memoization, one line per function
+*/
+std::string ProgramContext::describeMemoStatistics()
+{
+	std::string text;
+	for (size_t i = 0; i < memos.size(); i++)
+	{
+		if (!memos[i].enabled) continue;
+		memo_table & m = memos[i];
+		text += SymbolTable::instance().getName(SymbolId(i)) + ": " + std::to_string(m.hits) + " hits, " + std::to_string(m.misses)
+			+ " misses, " + std::to_string(m.results.size()) + " results cached";
+		if (getFunction(SymbolId(i)) == nullptr) text += " (not defined)";
+		else if (validateMemo(SymbolId(i)) == nullptr) text += " (not pure, calls are not memoized)";
+		text += "\n";
+	}
+	return text;
+}
+
+/*
+Initializes the turtle-describing variables
+*/
+void ProgramContext::turtleInit()
+{
+    x = HOME_X;
+    y = HOME_Y;
+    heading = HOME_HEADING;
+    pen_is_up = false;
+    red = 0;
+    green = 0;
+    blue = 0;
+}
+
+/*
+Moves the turtle forward by lenght (or backward, if negative)
+*/
+void ProgramContext::move_forward(int length)
+{
+
+    if(pen_is_up)
+    {
+        model->moveTurtlePointAngleLength(this->x, this->y, length, heading);
+    }
+    else
+    {
+        model->drawLinePointAngleLength(this->x, this->y, length, heading);
+    }
+}
+
+/*
+Turns the turtle by angle tenths of a degree
+*/
+void ProgramContext::turn_by(int angle)
+{
+    heading += angle;
+    heading %= 3600;
+}
+
+/*
+Sets turtle's heading
+*/
+void ProgramContext::set_heading(int angle)
+{
+    heading = angle;
+}
+
+/*
+Moves the turtle to the specified point
+*/
+void ProgramContext::move_to(int x, int y)
+{
+    if(pen_is_up)
+    {
+        model->moveTurtle2Point(x, y);
+    }
+    else
+    {
+        model->drawLine2Point(this->x, this->y, x, y);
+    }
+}
+
+/*
+Moves the turtle by a specified vector
+*/
+void ProgramContext::move_by(int x, int y)
+{
+    if(pen_is_up)
+    {
+        model->moveTurtle2Point(this->x + x, this->y + y);
+    }
+    else
+    {
+        model->drawLine2Point(this->x, this->y, this->x + x, this->y + y);
+    }
+}
+
+/*
+Lifts the pen
+*/
+void ProgramContext::pen_up()
+{
+    pen_is_up = true;
+}
+
+/*
+Lowers the pen
+*/
+void ProgramContext::pen_down()
+{
+    pen_is_up = false;
+}
+
+/*
+Clears the screen
+*/
+void ProgramContext::clear_screen()
+{
+    model->clearScreen();
+}
+
+/*
+Moves the turtle back to the middle of the screen
+*/
+void ProgramContext::go_home()
+{
+    move_to(HOME_X, HOME_Y);
+    heading = HOME_HEADING;
+}
+
+/*
+Sets the color of the pen
+*/
+void ProgramContext::set_color(int r, int g, int b)
+{
+    red = r;
+    green = g;
+    blue = b;
+    model->updateColor(r, g, b);
+}
+
+/*
+Returns current x
+*/
+int ProgramContext::getx()
+{
+    return x;
+}
+
+/*
+Returns current y
+*/
+int ProgramContext::gety()
+{
+    return y;
+}
+
+/*
+Returns current heading
+*/
+int ProgramContext::geth()
+{
+    return heading;
+}
+
+/*
+Writes to log
+*/
+void ProgramContext::writeToLog(std::string s)
+{
+    output_log += s;
+}
+
+/*
+Reads from log and clears it
+*/
+std::string ProgramContext::readFromLog()
+{
+    std::string s = std::string(output_log);
+    output_log = "";
+    return s;
+}
+
+/*
+Writes to error log
+*/
+void ProgramContext::writeToErrorLog(std::string s)
+{
+    error_log += s;
+}
+
+/*
+Reads from error log and clears it
+*/
+std::string ProgramContext::readFromErrorLog()
+{
+    std::string s = std::string(error_log);
+    error_log = "";
+    return s;
+}
+
+/*
+Gets a value from user
+*/
+int ProgramContext::getValueFromUser(std::string s)
+{
+    return model->getValueFromUser(s);
+}
+
+
+
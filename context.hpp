@@ -1,116 +1,238 @@
-#ifndef CONTEXT_H
-#define CONTEXT_H
-
-#pragma once
-#include <string>
-#include <map>
-#include <list>
-#include <iostream>
-
-typedef std::map<std::string, int> variable_table;
-
-
-class VariableSymbolTableStack
-{
-public:
-	VariableSymbolTableStack() = default;
-	void addVariable(std::string name, int value);
-	void addLocalVariable(std::string name, int value);
-	void pushVariableTable();
-	void popVariableTable();
-	bool existsVariable(std::string name);
-	bool existsLocalVariable(std::string name);
-	int getVariable(std::string name);
-
-private:
-	std::list<variable_table*> v;
-
-
-};
-
-class Statement;
-
-class FunctionDefinition;
-
-typedef std::map<std::string, FunctionDefinition *> function_table;
-
-class FunctionSymbolTable
-{
-public:
-	FunctionSymbolTable() = default;
-	FunctionDefinition * addFunction(FunctionDefinition * f, std::string name);
-	FunctionDefinition * getFunction(std::string name);
-	bool existsFunction(std::string name);
-    void restoreFunctionSymbolTable(FunctionSymbolTable * fun);
-    void removeFunction(std::string name);
-
-private:
-    function_table tab;
-
-};
-
-class Model;
-
-class ProgramContext
-{
-public:
-    ProgramContext() = default;
-	~ProgramContext() = default;
-
-	void addFunction(FunctionDefinition * f, std::string name);
-	FunctionDefinition * getFunction(std::string name);
-    void restoreFunctionSymbolTable(FunctionSymbolTable * fun);
-
-
-	int getVariable(std::string name);
-	void addVariable(std::string name, int value);
-	void addLocalVariable(std::string name, int value);
-	void pushContext();
-	void popContext();
-
-    void turtleInit();
-    void move_forward(int length);
-	void turn_by(int angle);
-	void set_heading(int angle);
-	void move_to(int x, int y);
-	void move_by(int x, int y);
-	void pen_up();
-	void pen_down();
-	void clear_screen();
-	void go_home();
-	void set_color(int r, int g, int b);
-
-	int getx();
-	int gety();
-	int geth();
-
-    void set_xy(int x, int y) { this->x = x; this->y = y; }
-
-    Model * model;
-
-    void writeToLog(std::string s);
-    std::string readFromLog();
-    void writeToErrorLog(std::string s);
-    std::string readFromErrorLog();
-    int getValueFromUser(std::string s);
-
-private:
-	FunctionSymbolTable function_table;
-	VariableSymbolTableStack variable_table_stack;
-
-    int x;
-    int y;
-
-    int heading;
-    bool pen_is_up;
-
-    int red;
-    int green;
-    int blue;
-
-    std::string output_log = "";
-    std::string error_log = "";
-
-};
-
-#endif
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#pragma once
+#include <string>
+#include <map>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <iostream>
+#include "symbol.hpp"
+#include "error.hpp"
+
+/*
+Variable storage: globals live in an array indexed by the SymbolId of their name,
+and every function call gets a contiguous frame of slots. Lookups keep the dynamic scoping of Logo,
+but a name which no active frame defines is read straight from the global array.
+*/
+class VariableSymbolTableStack
+{
+public:
+	VariableSymbolTableStack() = default;
+	void addVariable(SymbolId name, int value);
+	void addLocalVariable(SymbolId name, int value);
+	void setLocalVariable(int slot, int value);
+	void pushVariableTable();
+	void pushVariableTable(const std::vector<SymbolId> & layout);
+	void popVariableTable();
+	bool isFrameShadowedBy(const SymbolId * names, size_t count);
+	bool findVariable(SymbolId name, int & value);
+	bool findLocalVariable(int slot, int & value);
+
+private:
+	struct variable_slot
+	{
+		int name;
+		int value;
+		bool defined;
+	};
+
+	bool lookupInFrames(SymbolId name, int & value);
+	void reserve(SymbolId name);
+
+	std::vector<int> global_values;
+	std::vector<char> global_defined;
+	std::vector<int> shadow_count;
+	std::vector<variable_slot> locals;
+	std::vector<size_t> frame_base;
+};
+
+/*
+Reads a variable, looking through the active frames only if one of them defines the name; returns false if it does not exist
+*/
+inline bool VariableSymbolTableStack::findVariable(SymbolId name, int & value)
+{
+	if (size_t(name) >= shadow_count.size()) return false;
+	if (shadow_count[size_t(name)] != 0) return lookupInFrames(name, value);
+	if (!global_defined[size_t(name)]) return false;
+	value = global_values[size_t(name)];
+	return true;
+}
+
+/*
+Reads a slot of the current frame, falling back to the dynamic lookup if it was not defined yet
+*/
+inline bool VariableSymbolTableStack::findLocalVariable(int slot, int & value)
+{
+	variable_slot & v = locals[frame_base.back() + size_t(slot)];
+	if (!v.defined) return findVariable(v.name, value);
+	value = v.value;
+	return true;
+}
+
+class Statement;
+
+class FunctionDefinition;
+
+typedef std::vector<FunctionDefinition *> function_table;
+
+class FunctionSymbolTable
+{
+public:
+	FunctionSymbolTable() = default;
+	FunctionDefinition * addFunction(FunctionDefinition * f, SymbolId name);
+	FunctionDefinition * getFunction(SymbolId name) { return size_t(name) < tab.size() ? tab[size_t(name)] : nullptr; }
+	bool existsFunction(SymbolId name) { return getFunction(name) != nullptr; }
+    void restoreFunctionSymbolTable(FunctionSymbolTable * fun);
+    void removeFunction(SymbolId name);
+
+private:
+    function_table tab;
+
+};
+
+class Model;
+
+/*
+Function call being executed by the tree walker, linked to the call it was made from
+*/
+struct call_record
+{
+	SymbolId function;
+	position call_site;
+	call_record * caller;
+};
+
+/*
+Result of a memoized function call, replayed as the call would have returned it
+*/
+struct memo_result
+{
+	int integer_value;
+	bool returns_a_value;
+	bool is_output;
+};
+
+/*
+Hash of the argument values of a call
+*/
+struct argument_hash
+{
+	size_t operator()(const std::vector<int> & values) const;
+};
+
+/*
+Results of the calls of a function opted in to memoization, by argument values. The function is analysed again
+and the results dropped whenever a function is defined, as a redefinition can change its purity or its results
+*/
+struct memo_table
+{
+	bool enabled = false;
+	bool pure = false;
+	int generation = -1;
+	std::unordered_map<std::vector<int>, memo_result, argument_hash> results;
+	long long hits = 0;
+	long long misses = 0;
+};
+
+class ProgramContext
+{
+public:
+    ProgramContext() = default;
+	~ProgramContext() = default;
+
+	void addFunction(FunctionDefinition * f, SymbolId name);
+	FunctionDefinition * getFunction(SymbolId name) { return function_table.getFunction(name); }
+    void restoreFunctionSymbolTable(FunctionSymbolTable * fun);
+
+	bool findVariable(SymbolId name, int & value) { return variable_table_stack.findVariable(name, value); }
+	bool findLocalVariable(int slot, int & value) { return variable_table_stack.findLocalVariable(slot, value); }
+	void addVariable(SymbolId name, int value);
+	void addLocalVariable(SymbolId name, int value);
+	void setLocalVariable(int slot, int value) { variable_table_stack.setLocalVariable(slot, value); }
+	void pushContext();
+	void pushContext(const std::vector<SymbolId> & layout) { variable_table_stack.pushVariableTable(layout); }
+	void popContext();
+	bool isContextShadowedBy(const SymbolId * names, size_t count) { return variable_table_stack.isFrameShadowedBy(names, count); }
+
+	bool enterCall(call_record * c);
+	void leaveCall();
+	RuntimeError error(error_code c, position p);
+	int getMaxCallDepth() { return max_call_depth; }
+	void setMaxCallDepth(int depth) { max_call_depth = depth; }
+	void requestStop() { stop_requested.store(true, std::memory_order_relaxed); }
+	void resetStop() { stop_requested.store(false, std::memory_order_relaxed); }
+	bool isStopRequested() const { return stop_requested.load(std::memory_order_relaxed); }
+	bool sleepFor(int milliseconds);
+
+	void setMemoized(SymbolId name, bool enabled);
+	memo_table * getMemo(SymbolId name);
+	int getFunctionGeneration() const { return function_generation; }
+	std::string describeMemoStatistics();
+
+    void turtleInit();
+    void move_forward(int length);
+	void turn_by(int angle);
+	void set_heading(int angle);
+	void move_to(int x, int y);
+	void move_by(int x, int y);
+	void pen_up();
+	void pen_down();
+	void clear_screen();
+	void go_home();
+	void set_color(int r, int g, int b);
+
+	int getx();
+	int gety();
+	int geth();
+
+    void set_xy(int x, int y) { this->x = x; this->y = y; }
+
+    Model * model = nullptr;
+
+    void writeToLog(std::string s);
+    std::string readFromLog();
+    void writeToErrorLog(std::string s);
+    std::string readFromErrorLog();
+    int getValueFromUser(std::string s);
+
+private:
+	FunctionSymbolTable function_table;
+	VariableSymbolTableStack variable_table_stack;
+
+	int call_depth = 0;
+	int max_call_depth = 10000;
+	call_record * innermost_call = nullptr;
+	std::atomic<bool> stop_requested{ false };
+
+	memo_table * validateMemo(SymbolId name);
+	std::vector<memo_table> memos;
+	int function_generation = 0;
+
+    int x;
+    int y;
+
+    int heading;
+    bool pen_is_up;
+
+    int red;
+    int green;
+    int blue;
+
+    std::string output_log = "";
+    std::string error_log = "";
+
+};
+
+/*
+Returns the memo table of a function if it is opted in to memoization and pure, otherwise nullptr
+*/
+inline memo_table * ProgramContext::getMemo(SymbolId name)
+{
+	if (size_t(name) >= memos.size() || !memos[size_t(name)].enabled) return nullptr;
+	return validateMemo(name);
+}
+
+#endif
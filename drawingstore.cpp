@@ -0,0 +1,458 @@
+#include "drawingstore.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+/*
+Side of the square tiles, in pixels of its level, the images of the pyramid are stored by, and its power of two
+*/
+static const int level_tile_shift = 5;
+static const int level_tile = 1 << level_tile_shift;
+
+/*
+Returns the cell holding a coordinate, rounding down for the negative ones
+*/
+static long long cellOf(long long v, int cell)
+{
+	return v >= 0 ? v / cell : -((-v + cell - 1) / cell);
+}
+
+/*
+Returns the key of a cell in the grid
+*/
+static uint64_t cellKey(long long column, long long row)
+{
+	return uint64_t(uint32_t(column)) << 32 | uint64_t(uint32_t(row));
+}
+
+/*
+Returns the greatest common divisor of two numbers which are not negative
+*/
+static long long greatestCommonDivisor(long long a, long long b)
+{
+	while (b != 0)
+	{
+		long long r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+/*
+Hash of a supporting line
+*/
+size_t supporting_hash::operator()(const supporting_line & l) const
+{
+	size_t h = size_t(l.step_x);
+	h ^= size_t(l.step_y) + 0x9e3779b9u + (h << 6) + (h >> 2);
+	h ^= size_t(l.offset) + 0x9e3779b9u + (h << 6) + (h >> 2);
+	return h;
+}
+
+/*
+Clips a line to the square covered by the grid and the pyramid, from -indexed_extent included to indexed_extent excluded on both axes,
+by the parameters of its points along it; returns false if no part of it is inside
+*/
+static bool clipToIndexed(const stored_line & l, int & x1, int & y1, int & x2, int & y2)
+{
+	double dx = double(l.x2) - l.x1;
+	double dy = double(l.y2) - l.y1;
+	double low = 0;
+	double high = 1;
+	const double p[4] = { -dx, dx, -dy, dy };
+	const double q[4] = { double(l.x1) + DrawingStore::indexed_extent, DrawingStore::indexed_extent - 1.0 - l.x1,
+		double(l.y1) + DrawingStore::indexed_extent, DrawingStore::indexed_extent - 1.0 - l.y1 };
+	for (int i = 0; i < 4; i++)
+	{
+		if (p[i] == 0)
+		{
+			if (q[i] < 0) return false;
+			continue;
+		}
+		double t = q[i] / p[i];
+		if (p[i] < 0) low = std::max(low, t);
+		else high = std::min(high, t);
+	}
+	if (low > high) return false;
+	x1 = int(std::floor(l.x1 + low * dx + 0.5));
+	y1 = int(std::floor(l.y1 + low * dy + 0.5));
+	x2 = int(std::floor(l.x1 + high * dx + 0.5));
+	y2 = int(std::floor(l.y1 + high * dy + 0.5));
+	return true;
+}
+
+/*
+Keeps a line, culling the earlier lines it covers: those on its supporting line starting and ending within it
+*/
+void DrawingStore::drawLine2Point(int x1, int y1, int x2, int y2)
+{
+	stored_line l = { x1, y1, x2, y2, color, false };
+	uint32_t index = uint32_t(lines.size());
+	lines.push_back(l);
+
+	long long from, to;
+	collinear_lines & collinear = supports[supportOf(l, from, to)];
+	for (collinear_lines::iterator i = collinear.lower_bound(from); i != collinear.end() && i->first <= to;)
+	{
+		if (i->second.first > to)
+		{
+			i++;
+			continue;
+		}
+		lines[i->second.second].culled = true;
+		culled++;
+		culled_listed++;
+		i = collinear.erase(i);
+	}
+	collinear.insert(std::make_pair(from, std::make_pair(to, index)));
+
+	stored_line inside = l;
+	bool indexed = true;
+	if (std::min(x1, x2) < -indexed_extent || std::max(x1, x2) >= indexed_extent || std::min(y1, y2) < -indexed_extent || std::max(y1, y2) >= indexed_extent)
+	{
+		outside.push_back(index);
+		indexed = clipToIndexed(l, inside.x1, inside.y1, inside.x2, inside.y2);
+	}
+	if (indexed)
+	{
+		cellsOf(inside, keys);
+		for (std::vector<uint64_t>::const_iterator k = keys.begin(); k != keys.end(); k++)
+		{
+			cells[*k].push_back(index);
+		}
+		addToLevels(inside);
+	}
+	if (culled_listed > lines.size() - culled) compactCells();
+	extend(bounds, bounds_empty, boundsOf(l));
+	extend(changed, changed_empty, boundsOf(l));
+}
+
+/*
+Takes the culled lines out of the cells, dropping the cells left empty
+*/
+void DrawingStore::compactCells()
+{
+	for (cell_map::iterator c = cells.begin(); c != cells.end();)
+	{
+		std::vector<uint32_t> & listed = c->second;
+		listed.erase(std::remove_if(listed.begin(), listed.end(), [this](uint32_t i) { return lines[i].culled; }), listed.end());
+		if (listed.empty()) c = cells.erase(c);
+		else c++;
+	}
+	culled_listed = 0;
+}
+
+/*
+Draws a line inside the square of the grid into every image of the pyramid, with Bresenham's algorithm between
+the blocks holding its ends, or by filling the rows of the tiles it crosses when it stays in one row of blocks
+*/
+void DrawingStore::addToLevels(const stored_line & l)
+{
+	uint32_t pixel = l.color | 0xff000000;
+	for (int level = 1; level <= lod_levels; level++)
+	{
+		cell_map & tiles = pyramid[level - 1];
+		long long x = cellOf(l.x1, 1 << level);
+		long long y = cellOf(l.y1, 1 << level);
+		long long x2 = cellOf(l.x2, 1 << level);
+		long long y2 = cellOf(l.y2, 1 << level);
+		long long dx = std::abs(x2 - x);
+		long long dy = -std::abs(y2 - y);
+		int step_x = x < x2 ? 1 : -1;
+		int step_y = y < y2 ? 1 : -1;
+		long long error = dx + dy;
+		long long column = 0;
+		long long row = 0;
+		uint32_t * tile = nullptr;
+		if (y == y2)
+		{
+			if (x > x2) std::swap(x, x2);
+			row = y >> level_tile_shift;
+			for (column = x >> level_tile_shift; column <= x2 >> level_tile_shift; column++)
+			{
+				std::vector<uint32_t> & t = tiles[cellKey(column, row)];
+				if (t.empty()) t.resize(level_tile * level_tile);
+				tile = t.data() + ((y & (level_tile - 1)) << level_tile_shift);
+				std::fill(tile + std::max(x - (column << level_tile_shift), 0LL), tile + std::min(x2 - (column << level_tile_shift), (long long)level_tile - 1) + 1, pixel);
+			}
+			continue;
+		}
+		for (;;)
+		{
+			if (tile == nullptr || (x >> level_tile_shift) != column || (y >> level_tile_shift) != row)
+			{
+				column = x >> level_tile_shift;
+				row = y >> level_tile_shift;
+				std::vector<uint32_t> & t = tiles[cellKey(column, row)];
+				if (t.empty()) t.resize(level_tile * level_tile);
+				tile = t.data();
+			}
+			tile[(y & (level_tile - 1)) << level_tile_shift | (x & (level_tile - 1))] = pixel;
+			if (x == x2 && y == y2) break;
+			long long twice = 2 * error;
+			if (twice >= dy)
+			{
+				error += dy;
+				x += step_x;
+			}
+			if (twice <= dx)
+			{
+				error += dx;
+				y += step_y;
+			}
+		}
+	}
+}
+
+/*
+Keeps a line given by a point, a length and an angle
+*/
+void DrawingStore::drawLinePointAngleLength(int x1, int y1, int length, int angle)
+{
+	int x2, y2;
+	polarEndPoint(x1, y1, length, angle, x2, y2);
+	drawLine2Point(x1, y1, x2, y2);
+}
+
+/*
+Drops all the lines, the area they covered having to be painted again
+*/
+void DrawingStore::clearScreen()
+{
+	if (!bounds_empty) extend(changed, changed_empty, bounds);
+	lines.clear();
+	cells.clear();
+	supports.clear();
+	culled_listed = 0;
+	outside.clear();
+	for (int level = 0; level < lod_levels; level++)
+	{
+		pyramid[level].clear();
+	}
+	culled = 0;
+	bounds_empty = true;
+}
+
+/*
+Sets the color of the lines kept next
+*/
+void DrawingStore::updateColor(int r, int g, int b)
+{
+	color = uint32_t(r & 0xff) | uint32_t(g & 0xff) << 8 | uint32_t(b & 0xff) << 16;
+}
+
+/*
+Lists in drawing order the lines which are not culled and pass within a pixel of a rectangle, from the cells covering it,
+or from all the cells if there are fewer of them, and from the lines reaching out of the square of the grid if it does
+*/
+void DrawingStore::query(const drawing_rect & r, std::vector<uint32_t> & found) const
+{
+	found.clear();
+	if (r.left >= r.right || r.top >= r.bottom) return;
+	long long first_column = cellOf(r.left, cell);
+	long long last_column = cellOf((long long)r.right - 1, cell);
+	long long first_row = cellOf(r.top, cell);
+	long long last_row = cellOf((long long)r.bottom - 1, cell);
+
+	if ((last_column - first_column + 1) * (last_row - first_row + 1) <= (long long)cells.size())
+	{
+		for (long long row = first_row; row <= last_row; row++)
+		{
+			for (long long column = first_column; column <= last_column; column++)
+			{
+				cell_map::const_iterator c = cells.find(cellKey(column, row));
+				if (c != cells.end()) found.insert(found.end(), c->second.begin(), c->second.end());
+			}
+		}
+	}
+	else
+	{
+		for (cell_map::const_iterator c = cells.begin(); c != cells.end(); c++)
+		{
+			long long column = int32_t(uint32_t(c->first >> 32));
+			long long row = int32_t(uint32_t(c->first));
+			if (column >= first_column && column <= last_column && row >= first_row && row <= last_row) found.insert(found.end(), c->second.begin(), c->second.end());
+		}
+	}
+
+	if (r.left <= -indexed_extent || r.top <= -indexed_extent || r.right >= indexed_extent || r.bottom >= indexed_extent)
+	{
+		found.insert(found.end(), outside.begin(), outside.end());
+	}
+
+	std::sort(found.begin(), found.end());
+	found.erase(std::unique(found.begin(), found.end()), found.end());
+	found.erase(std::remove_if(found.begin(), found.end(), [this, &r](uint32_t i)
+	{
+		const stored_line & l = lines[i];
+		return l.culled || std::max(l.x1, l.x2) + 1 < r.left || std::min(l.x1, l.x2) - 1 >= r.right ||
+			std::max(l.y1, l.y2) + 1 < r.top || std::min(l.y1, l.y2) - 1 >= r.bottom;
+	}), found.end());
+}
+
+/*
+Copies the part of the image of a level of the pyramid covering a rectangle: gives the blocks it spans, in the pixels
+of the level, and their pixels row by row, opaque in the color of the last line crossing them and 0 where none does.
+The rectangle is first cut to the square of the pyramid
+*/
+void DrawingStore::renderLevel(int level, const drawing_rect & r, drawing_rect & blocks, std::vector<uint32_t> & pixels) const
+{
+	pixels.clear();
+	blocks = { 0, 0, 0, 0 };
+	drawing_rect inside = { std::max(r.left, -indexed_extent), std::max(r.top, -indexed_extent), std::min(r.right, int(indexed_extent)), std::min(r.bottom, int(indexed_extent)) };
+	if (level < 1 || level > lod_levels || inside.left >= inside.right || inside.top >= inside.bottom) return;
+	int size = 1 << level;
+	blocks = { int(cellOf(inside.left, size)), int(cellOf(inside.top, size)), int(cellOf((long long)inside.right - 1, size)) + 1, int(cellOf((long long)inside.bottom - 1, size)) + 1 };
+	int width = blocks.right - blocks.left;
+	pixels.assign(size_t(width) * size_t(blocks.bottom - blocks.top), 0);
+
+	const cell_map & tiles = pyramid[level - 1];
+	for (long long row = cellOf(blocks.top, level_tile); row <= cellOf(blocks.bottom - 1, level_tile); row++)
+	{
+		for (long long column = cellOf(blocks.left, level_tile); column <= cellOf(blocks.right - 1, level_tile); column++)
+		{
+			cell_map::const_iterator t = tiles.find(cellKey(column, row));
+			if (t == tiles.end()) continue;
+			long long left = std::max((long long)blocks.left, column * level_tile);
+			long long right = std::min((long long)blocks.right, column * level_tile + level_tile);
+			long long top = std::max((long long)blocks.top, row * level_tile);
+			long long bottom = std::min((long long)blocks.bottom, row * level_tile + level_tile);
+			for (long long y = top; y < bottom; y++)
+			{
+				const uint32_t * from = t->second.data() + (y - row * level_tile) * level_tile + left - column * level_tile;
+				std::copy(from, from + (right - left), pixels.begin() + (y - blocks.top) * width + (left - blocks.left));
+			}
+		}
+	}
+}
+
+/*
+Lists in drawing order the lines reaching out of the square of the pyramid which are not culled and pass within
+a pixel of a rectangle, for a view painting a level to draw them over it
+*/
+void DrawingStore::queryOutside(const drawing_rect & r, std::vector<uint32_t> & found) const
+{
+	found.clear();
+	for (std::vector<uint32_t>::const_iterator i = outside.begin(); i != outside.end(); i++)
+	{
+		const stored_line & l = lines[*i];
+		if (l.culled || std::max(l.x1, l.x2) + 1 < r.left || std::min(l.x1, l.x2) - 1 >= r.right ||
+			std::max(l.y1, l.y2) + 1 < r.top || std::min(l.y1, l.y2) - 1 >= r.bottom) continue;
+		found.push_back(*i);
+	}
+}
+
+/*
+Returns the level of the pyramid a view drawing at a scale should paint: the coarsest whose blocks are no wider
+than a pixel of the view, or 0 for the lines themselves when a pixel of the drawing is more than half a pixel of the view
+*/
+int DrawingStore::levelForScale(double scale)
+{
+	int level = 0;
+	while (level < lod_levels && scale * double(2 << level) <= 1.0) level++;
+	return level;
+}
+
+/*
+Gives the rectangle covering all the lines kept, within a pixel; returns false if there is none
+*/
+bool DrawingStore::getBounds(drawing_rect & r) const
+{
+	if (bounds_empty) return false;
+	r = bounds;
+	return true;
+}
+
+/*
+Gives the rectangle covering the lines kept or cleared since the last call, to be painted again; returns false
+if nothing changed
+*/
+bool DrawingStore::takeChanged(drawing_rect & r)
+{
+	if (changed_empty) return false;
+	r = changed;
+	changed_empty = true;
+	return true;
+}
+
+/*
+Lists the keys of the cells a line passes within a pixel of: for every row of cells, the columns between
+the ends of the part of the line crossing that row and a pixel around it
+*/
+void DrawingStore::cellsOf(const stored_line & l, std::vector<uint64_t> & out) const
+{
+	out.clear();
+	long long top = (long long)std::min(l.y1, l.y2) - 1;
+	long long bottom = (long long)std::max(l.y1, l.y2) + 1;
+	for (long long row = cellOf(top, cell); row <= cellOf(bottom, cell); row++)
+	{
+		long long left, right;
+		if (l.y1 == l.y2)
+		{
+			left = std::min(l.x1, l.x2);
+			right = std::max(l.x1, l.x2);
+		}
+		else
+		{
+			double low = double(std::max(row * cell - 1, top + 1) - l.y1);
+			double high = double(std::min(row * cell + cell, bottom - 1) - l.y1);
+			double slope = double(l.x2 - l.x1) / double(l.y2 - l.y1);
+			double a = l.x1 + low * slope;
+			double b = l.x1 + high * slope;
+			left = (long long)std::floor(std::min(a, b));
+			right = (long long)std::ceil(std::max(a, b));
+		}
+		for (long long column = cellOf(left - 1, cell); column <= cellOf(right + 1, cell); column++)
+		{
+			out.push_back(cellKey(column, row));
+		}
+	}
+}
+
+/*
+Returns the supporting line of a line and where the line starts and ends along it, as the product of its points
+with the direction; a line of no length is placed along the column of its point
+*/
+supporting_line DrawingStore::supportOf(const stored_line & l, long long & from, long long & to)
+{
+	long long dx = (long long)l.x2 - l.x1;
+	long long dy = (long long)l.y2 - l.y1;
+	if (dx == 0 && dy == 0)
+	{
+		from = l.y1;
+		to = l.y1;
+		return { 0, 0, l.x1 };
+	}
+	long long divisor = greatestCommonDivisor(std::abs(dx), std::abs(dy));
+	dx /= divisor;
+	dy /= divisor;
+	if (dx < 0 || (dx == 0 && dy < 0))
+	{
+		dx = -dx;
+		dy = -dy;
+	}
+	long long start = dx * l.x1 + dy * l.y1;
+	long long end = dx * l.x2 + dy * l.y2;
+	from = std::min(start, end);
+	to = std::max(start, end);
+	return { dx, dy, dx * l.y1 - dy * l.x1 };
+}
+
+/*
+Returns the rectangle covering a line within a pixel
+*/
+drawing_rect DrawingStore::boundsOf(const stored_line & l)
+{
+	return { std::min(l.x1, l.x2) - 1, std::min(l.y1, l.y2) - 1, std::max(l.x1, l.x2) + 2, std::max(l.y1, l.y2) + 2 };
+}
+
+/*
+Grows a rectangle, empty or not, to cover another one
+*/
+void DrawingStore::extend(drawing_rect & r, bool & empty, const drawing_rect & b)
+{
+	if (empty) r = b;
+	else r = { std::min(r.left, b.left), std::min(r.top, b.top), std::max(r.right, b.right), std::max(r.bottom, b.bottom) };
+	empty = false;
+}
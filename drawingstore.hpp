@@ -0,0 +1,122 @@
+#ifndef DRAWINGSTORE_H
+#define DRAWINGSTORE_H
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include "rendersink.hpp"
+
+/*
+Line kept by a DrawingStore, with the color it was drawn with (red in the lowest byte) and whether a later line hides it
+*/
+struct stored_line
+{
+	int x1;
+	int y1;
+	int x2;
+	int y2;
+	uint32_t color;
+	bool culled;
+};
+
+/*
+Rectangle of the drawing, from its first column and row included to its last column and row excluded
+*/
+struct drawing_rect
+{
+	int left;
+	int top;
+	int right;
+	int bottom;
+};
+
+/*
+Line through the points of a stored line: its direction reduced to the smallest step between integer points, pointing
+right or else down, and the offset telling the parallel lines apart; a line of no length has its point for offset
+*/
+struct supporting_line
+{
+	long long step_x;
+	long long step_y;
+	long long offset;
+	bool operator==(const supporting_line & o) const { return step_x == o.step_x && step_y == o.step_y && offset == o.offset; }
+};
+
+/*
+Hash of a supporting line
+*/
+struct supporting_hash
+{
+	size_t operator()(const supporting_line & l) const;
+};
+
+/*
+Render sink retaining the lines drawn since the last clear, for a view to paint the part of them it shows. The lines
+are indexed by a uniform grid of square cells, each cell listing in drawing order the lines passing within a pixel
+of it, so the lines meeting a rectangle are found from its cells alone. A line lying wholly on a later line is culled:
+the later one is drawn over it with the same width and an opaque color. Only lines on the same supporting line can
+cover each other, so the lines are also kept by supporting line, ordered by where they start along it, and a new line
+only looks at the ones starting within it. The culled lines are taken out of the cells once they are as many as the
+lines left, rather than on every insert.
+For views zoomed out, the store also keeps a pyramid of coarser images of the drawing: at level k a pixel stands for
+a block of 2^k by 2^k pixels and holds the color of the last line crossing it, so such a view paints one image of a
+bounded size instead of every line, however many lines there are. The grid and the pyramid only cover the square of
+side 2 * indexed_extent around the origin, so a line going far does not fill them; the lines reaching out of the square
+are listed apart, for the queries of rectangles reaching out of it and for the zoomed out views to draw them as lines
+*/
+class DrawingStore : public RenderSink
+{
+public:
+	explicit DrawingStore(int cell_size = 64) : cell(cell_size) {}
+	void drawLine2Point(int x1, int y1, int x2, int y2);
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle);
+	void moveTurtle2Point(int, int) {}
+	void moveTurtlePointAngleLength(int, int, int, int) {}
+	void clearScreen();
+	void updateColor(int r, int g, int b);
+
+	void query(const drawing_rect & r, std::vector<uint32_t> & found) const;
+	const stored_line & line(uint32_t index) const { return lines[index]; }
+	size_t size() const { return lines.size(); }
+	size_t getCulled() const { return culled; }
+	bool getBounds(drawing_rect & r) const;
+	bool takeChanged(drawing_rect & r);
+	void renderLevel(int level, const drawing_rect & r, drawing_rect & blocks, std::vector<uint32_t> & pixels) const;
+	void queryOutside(const drawing_rect & r, std::vector<uint32_t> & found) const;
+	static int levelForScale(double scale);
+
+	static const int lod_levels = 6;
+	static const int indexed_extent = 1 << 14;
+
+private:
+	typedef std::unordered_map<uint64_t, std::vector<uint32_t>> cell_map;
+	typedef std::multimap<long long, std::pair<long long, uint32_t>> collinear_lines;
+	typedef std::unordered_map<supporting_line, collinear_lines, supporting_hash> support_map;
+
+	void cellsOf(const stored_line & l, std::vector<uint64_t> & keys) const;
+	void addToLevels(const stored_line & l);
+	void compactCells();
+	static supporting_line supportOf(const stored_line & l, long long & from, long long & to);
+	static drawing_rect boundsOf(const stored_line & l);
+	static void extend(drawing_rect & r, bool & empty, const drawing_rect & b);
+
+	int cell;
+	uint32_t color = 0;
+	std::vector<stored_line> lines;
+	cell_map cells;
+	support_map supports;
+	size_t culled_listed = 0;
+	cell_map pyramid[lod_levels];
+	std::vector<uint32_t> outside;
+	size_t culled = 0;
+	drawing_rect bounds = { 0, 0, 0, 0 };
+	bool bounds_empty = true;
+	drawing_rect changed = { 0, 0, 0, 0 };
+	bool changed_empty = true;
+	bool cleared = false;
+	mutable std::vector<uint64_t> keys;
+};
+
+#endif
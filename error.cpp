@@ -0,0 +1,52 @@
+#include "error.hpp"
+
+/*
+Returns the message of the error, without its position
+*/
+const char * RuntimeError::message() const
+{
+	static const char * const messages[] = {
+		"No error!",
+		"Nonexistent variable!",
+		"Nonexistent function!",
+		"Division by zero!",
+		"Expected a function to return a value!",
+		"Maximum recursion depth exceeded!",
+		"Cannot sleep for a negative amount of miliseconds!",
+		"Execution stopped!",
+	};
+	static_assert(sizeof(messages) / sizeof(messages[0]) == E_COUNT, "messages do not match error_code");
+	return messages[code];
+}
+
+/*
+Formats a position as a line and a column counted from 1, locating it in the source if it was not located yet;
+the lexer takes the position of a token after reading its first byte, so the column already counts from 1
+*/
+static std::string describePosition(Source * s, position p)
+{
+	if (p.byte_number < 0) return "an unknown position";
+	if (p.row_number < 0) p = s->locate(p.byte_number);
+	return "line " + std::to_string(p.row_number + 1) + ", column " + std::to_string(p.column_number);
+}
+
+/*
+Formats the error for the error log: the message and its position, then one line for every function call it happened in,
+the same call repeated by a recursion being shown once with the number of repetitions
+*/
+std::string RuntimeError::describe(Source * s) const
+{
+	std::string text = std::string(message()) + " (" + describePosition(s, where) + ")\n";
+	std::vector<trace_entry>::const_iterator i = trace.begin();
+	while (i != trace.end())
+	{
+		std::vector<trace_entry>::const_iterator j = i + 1;
+		while (j != trace.end() && j->function == i->function && j->call_site.byte_number == i->call_site.byte_number) j++;
+
+		text += "  in " + SymbolTable::instance().getName(i->function) + ", called at " + describePosition(s, i->call_site);
+		if (j - i > 1) text += " (" + std::to_string(j - i) + " times)";
+		text += "\n";
+		i = j;
+	}
+	return text;
+}
@@ -0,0 +1,52 @@
+#ifndef ERROR_H
+#define ERROR_H
+
+#pragma once
+#include <string>
+#include <vector>
+#include "symbol.hpp"
+#include "source.hpp"
+
+/*
+Kinds of errors raised while a program runs
+*/
+enum error_code
+{
+	E_NONE,
+	E_NONEXISTENT_VARIABLE,
+	E_NONEXISTENT_FUNCTION,
+	E_DIVISION_BY_ZERO,
+	E_NO_RETURN_VALUE,
+	E_RECURSION_DEPTH,
+	E_NEGATIVE_SLEEP,
+	E_STOPPED,
+	E_COUNT
+};
+
+/*
+Function call active when an error was raised, with the position it was called from
+*/
+struct trace_entry
+{
+	SymbolId function;
+	position call_site;
+};
+
+/*
+Error raised while a program runs: its kind, the position of the expression or statement raising it,
+and the function calls it happened in, innermost first
+*/
+class RuntimeError
+{
+public:
+	RuntimeError() = default;
+	RuntimeError(error_code c, position p) : code(c), where(p) {}
+	const char * message() const;
+	std::string describe(Source * s) const;
+
+	error_code code = E_NONE;
+	position where = { -1, -1, -1 };
+	std::vector<trace_entry> trace;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "geometry.hpp"
+#include <cmath>
+
+/*
+Sines of the headings of a turn, built once. Only the first quarter is computed and the other quarters mirror it,
+so the headings symmetric to each other have exactly opposite or equal values; the sines which are rational (0, 1/2
+and 1, at 0, 30 and 90 degrees) are set exactly, so the halves they give are rounded the same way on every platform
+*/
+struct heading_table
+{
+	heading_table()
+	{
+		const int quarter = FULL_TURN / 4;
+		double first[FULL_TURN / 4 + 1];
+		for (int h = 0; h <= quarter; h++)
+		{
+			first[h] = std::sin(h * M_PI / (FULL_TURN / 2));
+		}
+		first[0] = 0.0;
+		first[quarter / 3] = 0.5;
+		first[quarter] = 1.0;
+
+		for (int h = 0; h < FULL_TURN; h++)
+		{
+			if (h <= quarter) sines[h] = first[h];
+			else if (h <= 2 * quarter) sines[h] = first[2 * quarter - h];
+			else if (h <= 3 * quarter) sines[h] = -first[h - 2 * quarter];
+			else sines[h] = -first[FULL_TURN - h];
+		}
+	}
+
+	double sines[FULL_TURN];
+};
+
+/*
+Returns the table of the sines
+*/
+static const heading_table & table()
+{
+	static const heading_table t;
+	return t;
+}
+
+/*
+Rounds to the nearest integer, halves rounded up, without a call to the math library
+*/
+static int roundHalfUp(double v)
+{
+	v += 0.5;
+	int i = int(v);
+	return i > v ? i - 1 : i;
+}
+
+/*
+Returns the heading between 0 and a full turn excluded pointing the same way as an angle
+*/
+int normalizeHeading(int angle)
+{
+	angle %= FULL_TURN;
+	return angle < 0 ? angle + FULL_TURN : angle;
+}
+
+/*
+Returns the sine of an angle in tenths of a degree
+*/
+double headingSine(int angle)
+{
+	return table().sines[normalizeHeading(angle)];
+}
+
+/*
+Returns the cosine of an angle in tenths of a degree
+*/
+double headingCosine(int angle)
+{
+	return table().sines[normalizeHeading(normalizeHeading(angle) + FULL_TURN / 4)];
+}
+
+/*
+Calculates the point reached from a given point at an angle (in tenths of a degree) by length,
+rounded to the nearest pixel, halves rounded up
+*/
+void polarEndPoint(int x1, int y1, int length, int angle, int & x2, int & y2)
+{
+	x2 = roundHalfUp(x1 + headingCosine(angle) * length);
+	y2 = roundHalfUp(y1 - headingSine(angle) * length);
+}
@@ -0,0 +1,18 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#pragma once
+
+/*
+Geometry of the turtle, independent of any GUI. Headings are in tenths of a degree, counterclockwise from the
+x axis with y growing downwards, so their sines and cosines are read from a table of the 3600 headings of a turn
+rather than computed for every segment
+*/
+const int FULL_TURN = 3600;
+
+int normalizeHeading(int angle);
+double headingSine(int angle);
+double headingCosine(int angle);
+void polarEndPoint(int x1, int y1, int length, int angle, int & x2, int & y2);
+
+#endif
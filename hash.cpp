@@ -1,73 +1,73 @@
-#include "hash.hpp"
-
-/*
-Constructor of the Keyword class
-*/
-KeywordMap::KeywordMap()
-{
-	k.insert(keyword_map::value_type(hash("or"), "or"));
-	k.insert(keyword_map::value_type(hash("xor"), "xor"));
-	k.insert(keyword_map::value_type(hash("and"), "and"));
-	k.insert(keyword_map::value_type(hash("not"), "not"));
-	k.insert(keyword_map::value_type(hash("fd"), "fd"));
-	k.insert(keyword_map::value_type(hash("bk"), "bk"));
-	k.insert(keyword_map::value_type(hash("rt"), "rt"));
-	k.insert(keyword_map::value_type(hash("lt"), "lt"));
-	k.insert(keyword_map::value_type(hash("move"), "move"));
-	k.insert(keyword_map::value_type(hash("setxy"), "setxy"));
-	k.insert(keyword_map::value_type(hash("head"), "head"));
-	k.insert(keyword_map::value_type(hash("home"), "home"));
-	k.insert(keyword_map::value_type(hash("getx"), "getx"));
-	k.insert(keyword_map::value_type(hash("gety"), "gety"));
-	k.insert(keyword_map::value_type(hash("getheading"), "getheading"));
-	k.insert(keyword_map::value_type(hash("cs"), "cs"));
-	k.insert(keyword_map::value_type(hash("pu"), "pu"));
-	k.insert(keyword_map::value_type(hash("pd"), "pd"));
-	k.insert(keyword_map::value_type(hash("setcolor"), "setcolor"));
-	k.insert(keyword_map::value_type(hash("output"), "output"));
-	k.insert(keyword_map::value_type(hash("print"), "print"));
-	k.insert(keyword_map::value_type(hash("scan"), "scan"));
-	k.insert(keyword_map::value_type(hash("make"), "make"));
-	k.insert(keyword_map::value_type(hash("local"), "local"));
-	k.insert(keyword_map::value_type(hash("if"), "if"));
-	k.insert(keyword_map::value_type(hash("repeat"), "repeat"));
-	k.insert(keyword_map::value_type(hash("to"), "to"));
-	k.insert(keyword_map::value_type(hash("end"), "end"));
-	k.insert(keyword_map::value_type(hash("true"), "true"));
-	k.insert(keyword_map::value_type(hash("false"), "false"));
-	k.insert(keyword_map::value_type(hash("sleep"), "sleep"));
-}
-
-/*
-Returns true if a given string exists in the keyword map
-*/
-bool KeywordMap::checkHash(std::string s)
-{
-	std::map <int, std::string> :: const_iterator i = k.find(hash(s));
-	if (i == k.end())
-	{
-		return false;
-	}
-
-	if (i->second == s)
-	{
-		return true;
-	}
-	else 
-	{
-		return false;
-	}
-}
-
-/*
-Returns the calculated hash of the input string
-*/
-int KeywordMap::hash(std::string s)
-{
-	int h = 0;
-	for (int i = int(s.length() - 1); i >= 0; i--)
-	{
-		h = (p * h + int(s[i])) % q;
-	}
-	return h;
-}
\ No newline at end of file
+#include "hash.hpp"
+#include <cstring>
+
+/*
+Spelling of every keyword, in the order of keyword_type
+*/
+static constexpr const char * keyword_spelling[K_COUNT] = {
+	"or", "xor", "and", "not", "fd", "bk", "rt", "lt", "move", "setxy", "head", "home", "getx", "gety",
+	"getheading", "cs", "pu", "pd", "setcolor", "output", "print", "scan", "make", "local", "if", "repeat",
+	"to", "end", "true", "false", "sleep"
+};
+
+/*
+Table of the keywords: each slot holds the keyword_type whose spelling hashes to it, or -1
+*/
+struct keyword_table
+{
+	signed char slots[KeywordHash::table_size];
+};
+
+/*
+Length of a spelling, usable at compile time
+*/
+static constexpr size_t spellingLength(const char * s)
+{
+	size_t n = 0;
+	while (s[n] != '\0') n++;
+	return n;
+}
+
+/*
+Places every keyword in the slot given by its hash
+*/
+static constexpr keyword_table buildKeywordTable()
+{
+	keyword_table t = {};
+	for (unsigned i = 0; i < KeywordHash::table_size; i++) t.slots[i] = -1;
+	for (int k = 0; k < K_COUNT; k++)
+	{
+		t.slots[KeywordHash::slot(keyword_spelling[k], spellingLength(keyword_spelling[k]))] = (signed char)k;
+	}
+	return t;
+}
+
+/*
+Checks that no two keywords share a slot and that none is longer than the recognizer accepts
+*/
+static constexpr bool isPerfect(const keyword_table & t)
+{
+	for (int k = 0; k < K_COUNT; k++)
+	{
+		size_t length = spellingLength(keyword_spelling[k]);
+		if (length > KeywordHash::max_length) return false;
+		if (t.slots[KeywordHash::slot(keyword_spelling[k], length)] != k) return false;
+	}
+	return true;
+}
+
+static constexpr keyword_table keywords = buildKeywordTable();
+static_assert(isPerfect(keywords), "The keyword hash has collisions, its multipliers need to be changed");
+
+/*
+Returns the keyword_type of the given word, -1 if it is not a keyword
+*/
+int KeywordHash::find(const char * s, size_t length)
+{
+	if (length < 2 || length > max_length) return -1;
+	int k = keywords.slots[slot(s, length)];
+	if (k < 0) return -1;
+	const char * candidate = keyword_spelling[k];
+	if (std::strncmp(candidate, s, length) != 0 || candidate[length] != '\0') return -1;
+	return k;
+}
@@ -1,26 +1,28 @@
-#ifndef HASH_H
-#define HASH_H
-
-#pragma once
-#include <string>
-#include <map>
-
-typedef std::map<int, std::string> keyword_map;
-
-class KeywordMap
-{
-public:
-	KeywordMap();
-	bool checkHash(std::string s);
-	
-
-private:
-	int p = 71;
-	int q = 9887;
-	keyword_map k;
-	int hash(std::string s);
-	
-
-};
-
-#endif
+#ifndef HASH_H
+#define HASH_H
+
+#pragma once
+#include <cstddef>
+
+enum keyword_type {K_OR, K_XOR, K_AND, K_NOT, K_FD, K_BK, K_RT, K_LT, K_MOVE, K_SETXY, K_HEAD, K_HOME, K_GETX, K_GETY, K_GETHEADING, K_CS, K_PU, K_PD, K_SETCOLOR, K_OUTPUT, K_PRINT, K_SCAN, K_MAKE, K_LOCAL, K_IF, K_REPEAT, K_TO, K_END, K_TRUE, K_FALSE, K_SLEEP, K_COUNT };
+
+/*
+Perfect hash of the keywords; the length and the first, second and last characters of a word select
+a single slot of a table generated at compile time, so recognizing a word takes one probe and one comparison
+*/
+class KeywordHash
+{
+public:
+	static constexpr unsigned table_size = 64;
+	static constexpr size_t max_length = 10;
+
+	static constexpr unsigned slot(const char * s, size_t length)
+	{
+		return (unsigned(length) + 6u * (unsigned char)s[0] + 31u * (unsigned char)s[length > 1 ? 1 : 0]
+			+ 15u * (unsigned char)s[length - 1]) & (table_size - 1);
+	}
+
+	static int find(const char * s, size_t length);
+};
+
+#endif
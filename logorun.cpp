@@ -0,0 +1,313 @@
+#include "model.hpp"
+#include "raster.hpp"
+#include "vectorsink.hpp"
+#include "trace.hpp"
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <csignal>
+#include <cstdio>
+
+/*
+Model running the script, stopped by the first interrupt
+*/
+static Model * running_model = nullptr;
+
+/*
+Asks the running script to stop at its next loop iteration, call or sleep; a second interrupt ends the process
+*/
+static void interrupt(int)
+{
+	if (running_model != nullptr) running_model->requestStop();
+	std::signal(SIGINT, SIG_DFL);
+}
+
+/*
+Prints the command line usage of logo-run
+*/
+static void usage()
+{
+	std::cerr << "Usage: logo-run [--sink null|record|png|svg|lines] [-o file] [--size WxH] [--antialias] [--threads n] [--reference] [--max-depth n] [--memo name]... [--memo-stats] [--coalesce] [--coalesce-stats] [--trace file] [--replay file] [script]\n"
+		<< "  Executes the script (or standard input line by line, until \"exit\") without a GUI.\n"
+		<< "  An interrupt (Ctrl+C) stops the running statement with an error, a second one ends logo-run.\n"
+		<< "  --sink null     discards the drawing output (default)\n"
+		<< "  --sink record   writes every drawing call as a line of text\n"
+		<< "  --sink png      draws into an image written as PNG to the -o file at the end\n"
+		<< "  --sink svg      streams the drawing as an SVG document, one path per run of lines of one color\n"
+		<< "  --sink lines    streams the drawing as a binary list of lines, colors and clears\n"
+		<< "  -o file         file the drawing output is written to (default: standard output; required for png)\n"
+		<< "  --size WxH      size of the PNG image or of the SVG and line list canvas in pixels (default: 500x500)\n"
+		<< "  --antialias     draws antialiased lines into the PNG image\n"
+		<< "  --threads n     draws the PNG image by tiles on n threads, in batches of the drawing calls (default: 1)\n"
+		<< "  --reference     executes with the tree-walking interpreter instead of the bytecode VM\n"
+		<< "  --max-depth n   number of nested function calls allowed before stopping with an error (default: 10000)\n"
+		<< "  --memo name     caches the results of the function by its arguments, if the function is pure\n"
+		<< "  --memo-stats    writes the hits and misses of the cached functions to standard error at the end\n"
+		<< "  --coalesce      merges the consecutive lines continuing each other into one before they reach the sink\n"
+		<< "  --coalesce-stats  writes how many lines the merging eliminated to standard error at the end\n"
+		<< "  --trace file    records the drawing calls into a compact binary trace file as well\n"
+		<< "  --replay file   draws the calls of a trace file into the sink instead of executing a script\n";
+}
+
+/*
+Forwards the logs of processed statements, returns false if an error was reported
+*/
+static bool report(OutputLog * log)
+{
+	bool ok = log->err_log.empty();
+	std::cout << log->log;
+	std::cerr << log->err_log;
+	delete log;
+	return ok;
+}
+
+int main(int argc, char * argv[])
+{
+	std::string sink_name = "null";
+	std::string output_name = "";
+	std::string script_name = "";
+	bool reference = false;
+	int max_depth = 0;
+	std::vector<std::string> memoized;
+	bool memo_stats = false;
+	bool coalesce = false;
+	bool coalesce_stats = false;
+	int width = 500;
+	int height = 500;
+	bool antialias = false;
+	int threads = 1;
+	std::string trace_name = "";
+	std::string replay_name = "";
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--sink") == 0 && i + 1 < argc)
+		{
+			sink_name = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			output_name = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--reference") == 0)
+		{
+			reference = true;
+		}
+		else if (std::strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc)
+		{
+			max_depth = std::atoi(argv[++i]);
+			if (max_depth <= 0)
+			{
+				usage();
+				return 2;
+			}
+		}
+		else if (std::strcmp(argv[i], "--memo") == 0 && i + 1 < argc)
+		{
+			memoized.push_back(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--memo-stats") == 0)
+		{
+			memo_stats = true;
+		}
+		else if (std::strcmp(argv[i], "--coalesce") == 0)
+		{
+			coalesce = true;
+		}
+		else if (std::strcmp(argv[i], "--coalesce-stats") == 0)
+		{
+			coalesce = true;
+			coalesce_stats = true;
+		}
+		else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+		{
+			if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+			{
+				usage();
+				return 2;
+			}
+		}
+		else if (std::strcmp(argv[i], "--antialias") == 0)
+		{
+			antialias = true;
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threads = std::atoi(argv[++i]);
+			if (threads <= 0)
+			{
+				usage();
+				return 2;
+			}
+		}
+		else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+		{
+			trace_name = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+		{
+			replay_name = argv[++i];
+		}
+		else if (argv[i][0] == '-' && argv[i][1] != '\0')
+		{
+			usage();
+			return 2;
+		}
+		else
+		{
+			script_name = argv[i];
+		}
+	}
+
+	if ((sink_name == "png" && output_name.empty()) || (!replay_name.empty() && !script_name.empty()))
+	{
+		usage();
+		return 2;
+	}
+
+	std::ofstream output_file;
+	std::ostream * output = &std::cout;
+	if (!output_name.empty() && sink_name != "png")
+	{
+		output_file.open(output_name, std::ios::binary);
+		if (!output_file)
+		{
+			std::cerr << "Cannot open " << output_name << " for writing\n";
+			return 2;
+		}
+		output = &output_file;
+	}
+
+	RenderSink * sink = nullptr;
+	RasterSink * raster = nullptr;
+	SvgSink * svg = nullptr;
+	LineListSink * line_list = nullptr;
+	CommandBuffer * batches = nullptr;
+	if (sink_name == "null")
+	{
+		sink = new NullSink();
+	}
+	else if (sink_name == "record")
+	{
+		sink = new RecordingSink(*output);
+	}
+	else if (sink_name == "svg")
+	{
+		svg = new SvgSink(*output, width, height);
+		sink = svg;
+	}
+	else if (sink_name == "lines")
+	{
+		line_list = new LineListSink(*output, width, height);
+		sink = line_list;
+	}
+	else if (sink_name == "png")
+	{
+		raster = new RasterSink(width, height, antialias);
+		sink = raster;
+		if (threads > 1)
+		{
+			raster->setThreads(unsigned(threads));
+			batches = new CommandBuffer(raster);
+			sink = batches;
+		}
+	}
+	else
+	{
+		usage();
+		return 2;
+	}
+
+	std::ofstream trace_file;
+	TraceRecorder * recorder = nullptr;
+	if (!trace_name.empty())
+	{
+		trace_file.open(trace_name, std::ios::binary);
+		if (!trace_file)
+		{
+			std::cerr << "Cannot open " << trace_name << " for writing\n";
+			delete sink;
+			if (batches != nullptr) delete raster;
+			return 2;
+		}
+		recorder = new TraceRecorder(trace_file, sink);
+	}
+	RenderSink * drawing = recorder != nullptr ? (RenderSink *)recorder : sink;
+
+	bool ok = true;
+	if (!replay_name.empty())
+	{
+		Source trace;
+		if (!trace.mapFile(replay_name))
+		{
+			std::cerr << "Cannot open " << replay_name << "\n";
+			ok = false;
+		}
+		else if (!replayTrace(trace.getData(), trace.getLength(), drawing))
+		{
+			std::cerr << replay_name << " is not a valid drawing trace\n";
+			ok = false;
+		}
+		drawing->flush();
+	}
+	else
+	{
+		Model m(drawing, reference);
+		if (max_depth > 0) m.setMaxCallDepth(max_depth);
+		m.setCoalescing(coalesce);
+		for (std::vector<std::string>::const_iterator i = memoized.begin(); i != memoized.end(); i++)
+		{
+			m.setMemoized(*i, true);
+		}
+		running_model = &m;
+		std::signal(SIGINT, interrupt);
+
+		if (!script_name.empty())
+		{
+			OutputLog * log = m.processFile(script_name);
+			if (log == nullptr)
+			{
+				std::cerr << "Cannot open " << script_name << "\n";
+				delete recorder;
+				delete sink;
+				if (batches != nullptr) delete raster;
+				return 2;
+			}
+			ok = report(log);
+		}
+		else
+		{
+			std::string str;
+			while (std::getline(std::cin, str) && str != "exit")
+			{
+				ok = report(m.processStatements(str)) && ok;
+			}
+		}
+
+		if (memo_stats) std::cerr << m.getMemoStatistics();
+		if (coalesce_stats) std::cerr << m.getCoalescingStatistics();
+		std::signal(SIGINT, SIG_DFL);
+		running_model = nullptr;
+	}
+
+	if (recorder != nullptr && !recorder->finish())
+	{
+		std::cerr << "Cannot write " << trace_name << "\n";
+		ok = false;
+	}
+	if ((svg != nullptr && !svg->finish()) || (line_list != nullptr && !line_list->finish()))
+	{
+		std::cerr << "Cannot write " << output_name << "\n";
+		ok = false;
+	}
+	if (batches != nullptr) batches->flush();
+	if (raster != nullptr && !raster->writePng(output_name))
+	{
+		std::cerr << "Cannot write " << output_name << "\n";
+		ok = false;
+	}
+	delete recorder;
+	delete sink;
+	if (batches != nullptr) delete raster;
+	return ok ? 0 : 1;
+}
@@ -1,92 +1,246 @@
-#include "mainwindow.hpp"
-#include "ui_mainwindow.h"
-
-MainWindow::MainWindow(QWidget *parent) :
-    QMainWindow(parent),
-    ui(new Ui::MainWindow)
-{
-    model = new Model(this);
-    pen = new QPen(QColor(0,0,0,255));
-    ui->setupUi(this);
-
-    scene = new QGraphicsScene(this);
-    scene->setSceneRect(QRectF(0, 0, 500, 500));
-    ui->graphicsView->setScene(scene);
-}
-
-MainWindow::~MainWindow()
-{
-    delete ui;
-    delete model;
-    delete pen;
-    delete scene;
-}
-
-void MainWindow::on_pushButton_clicked()
-{
-    QString input = ui->plainTextEdit->toPlainText();
-    std::string input_std_string = input.toStdString();
-    OutputLog * output_string_pair = model->processStatements(input_std_string);
-    QString log = QString::fromStdString(output_string_pair->log);
-    QString err_log = QString::fromStdString(output_string_pair->err_log);
-
-    ui->label->setText(err_log);
-    ui->plainTextEdit_2->insertPlainText(log);
-
-    delete output_string_pair;
-}
-
-void MainWindow::setColor(int r, int g, int b)
-{
-   pen->setColor(QColor(r, g, b, 255));
-}
-
-void MainWindow::clearScreen()
-{
-    scene->clear();
-    qApp->processEvents();
-}
-
-void MainWindow::drawLine2Point(int x1, int y1, int x2, int y2)
-{
-    scene->addLine(x1, y1, x2, y2, *pen);
-    model->set_xy(x2, y2);
-    qApp->processEvents();
-}
-
-void MainWindow::drawLinePointAngleLength(int x1, int y1, int length, int angle)
-{
-    double a = angle;
-    a /= 10;
-    if(a > 180) a = a - 360;
-    QLineF line = QLineF(x1, y1, 0, 0);
-    line.setAngle(a);
-    line.setLength(length);
-    QPointF p = line.p2();
-    QPoint newp = p.toPoint();
-    int newx1 = newp.rx();
-    int newy1 = newp.ry();
-    model->set_xy(newx1, newy1);
-    scene->addLine(line, *pen);
-    qApp->processEvents();
-}
-
-void MainWindow::moveTurtle2Point(int x2, int y2)
-{
-    model->set_xy(x2, y2);
-}
-
-void MainWindow::moveTurtlePointAngleLength(int x1, int y1, int length, int angle)
-{
-    double a = angle;
-    a /= 10;
-    if(a > 180) a = a - 360;
-    QLineF line = QLineF(x1, y1, 0, 0);
-    line.setAngle(a);
-    line.setLength(length);
-    QPointF p = line.p2();
-    QPoint newp = p.toPoint();
-    int newx1 = newp.rx();
-    int newy1 = newp.ry();
-    model->set_xy(newx1, newy1);
-}
+#include "mainwindow.hpp"
+#include "ui_mainwindow.h"
+#include <QCoreApplication>
+#include <QInputDialog>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+
+#define FRAME_MILLISECONDS 16
+#define BATCH_SIZE 16384
+#define BATCHES_PER_FRAME 8
+
+MainWindow::MainWindow(QWidget *parent) :
+    QMainWindow(parent),
+    ui(new Ui::MainWindow),
+    finished_log(nullptr),
+    running(false),
+    batch(BATCH_SIZE)
+{
+    queue = new CommandQueue();
+    queue_sink = new QueueSink(queue, this);
+    buffer = new CommandBuffer(queue_sink);
+    model = new Model(buffer);
+    model->setCoalescing(true);
+    ui->setupUi(this);
+
+    scene = new QGraphicsScene(this);
+    scene->setSceneRect(QRectF(0, 0, 500, 500));
+    ui->graphicsView->setScene(scene);
+    drawing = new DrawingItem(&store);
+    scene->addItem(drawing);
+
+    frame_timer = new QTimer(this);
+    connect(frame_timer, &QTimer::timeout, this, &MainWindow::drainCommands);
+}
+
+MainWindow::~MainWindow()
+{
+    if(running)
+    {
+        frame_timer->stop();
+        model->requestStop();
+        while(finished_log.load() == nullptr)
+        {
+            queue->pop(batch.data(), batch.size());
+            QCoreApplication::processEvents();
+            std::this_thread::yield();
+        }
+        worker.join();
+        delete finished_log.load();
+    }
+    delete ui;
+    delete model;
+    delete buffer;
+    delete queue_sink;
+    delete queue;
+    delete scene;
+}
+
+void MainWindow::on_pushButton_clicked()
+{
+    if(running)
+    {
+        model->requestStop();
+        return;
+    }
+
+    QString input = ui->plainTextEdit->toPlainText();
+    std::string input_std_string = input.toStdString();
+    model->resetStop();
+    running = true;
+    button_text = ui->pushButton->text();
+    ui->pushButton->setText("Stop");
+    worker = std::thread([this, input_std_string]()
+    {
+        OutputLog * log = model->processStatements(input_std_string);
+        buffer->flush();
+        finished_log.store(log);
+    });
+    frame_timer->start(FRAME_MILLISECONDS);
+}
+
+void MainWindow::drainCommands()
+{
+    bool finished = finished_log.load() != nullptr;
+    for(int i = 0; finished || i < BATCHES_PER_FRAME; i++)
+    {
+        size_t count = queue->pop(batch.data(), batch.size());
+        if(count == 0) break;
+        drawCommands(batch.data(), count);
+    }
+    if(finished) finishRun();
+}
+
+void MainWindow::finishRun()
+{
+    frame_timer->stop();
+    worker.join();
+    running = false;
+    ui->pushButton->setText(button_text);
+
+    OutputLog * output_string_pair = finished_log.exchange(nullptr);
+    QString log = QString::fromStdString(output_string_pair->log);
+    QString err_log = QString::fromStdString(output_string_pair->err_log);
+
+    ui->label->setText(err_log);
+    ui->plainTextEdit_2->insertPlainText(log);
+
+    delete output_string_pair;
+}
+
+void MainWindow::updateColor(int r, int g, int b)
+{
+    store.updateColor(r, g, b);
+}
+
+void MainWindow::clearScreen()
+{
+    store.clearScreen();
+    drawing->refresh();
+}
+
+void MainWindow::drawLine2Point(int x1, int y1, int x2, int y2)
+{
+    store.drawLine2Point(x1, y1, x2, y2);
+    drawing->refresh();
+}
+
+void MainWindow::drawLinePointAngleLength(int x1, int y1, int length, int angle)
+{
+    store.drawLinePointAngleLength(x1, y1, length, angle);
+    drawing->refresh();
+}
+
+void MainWindow::drawCommands(const render_command * first, size_t count)
+{
+    store.drawCommands(first, count);
+    drawing->refresh();
+}
+
+void MainWindow::moveTurtle2Point(int, int)
+{
+}
+
+void MainWindow::moveTurtlePointAngleLength(int, int, int, int)
+{
+}
+
+int MainWindow::getValueFromUser(std::string s)
+{
+    int value = 0;
+    if(model->isStopRequested()) return value;
+    QMetaObject::invokeMethod(this, [this, s, &value]()
+    {
+        if(model->isStopRequested()) return;
+        drainCommands();
+        QString title = QString("Input");
+        std::string str = "Please input the value of the variable: "  + s;
+        QString label = QString::fromStdString(str);
+        value = QInputDialog::getInt(this, title, label, 0);
+    }, Qt::BlockingQueuedConnection);
+    return value;
+}
+
+DrawingItem::DrawingItem(DrawingStore *s) :
+    store(s),
+    bounds(0, 0, 500, 500)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+QRectF DrawingItem::boundingRect() const
+{
+    return bounds;
+}
+
+static void drawRun(QPainter *painter, const std::vector<QLine> &run, uint32_t color)
+{
+    painter->setPen(QPen(QColor(color & 0xff, (color >> 8) & 0xff, (color >> 16) & 0xff, 255)));
+    painter->drawLines(run.data(), int(run.size()));
+}
+
+void DrawingItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *)
+{
+    QRect exposed = option->exposedRect.toAlignedRect();
+    drawing_rect r = { exposed.left(), exposed.top(), exposed.right() + 1, exposed.bottom() + 1 };
+    int level = DrawingStore::levelForScale(QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform()));
+    if(level > 0)
+    {
+        paintLevel(painter, r, level);
+        store->queryOutside(r, visible);
+    }
+    else
+    {
+        store->query(r, visible);
+    }
+    paintVisible(painter);
+}
+
+void DrawingItem::paintVisible(QPainter *painter)
+{
+    uint32_t color = 0;
+    run.clear();
+    for(std::vector<uint32_t>::const_iterator i = visible.begin(); i != visible.end(); i++)
+    {
+        const stored_line &l = store->line(*i);
+        if(!run.empty() && l.color != color)
+        {
+            drawRun(painter, run, color);
+            run.clear();
+        }
+        color = l.color;
+        run.push_back(QLine(l.x1, l.y1, l.x2, l.y2));
+    }
+    if(!run.empty()) drawRun(painter, run, color);
+}
+
+void DrawingItem::paintLevel(QPainter *painter, const drawing_rect &exposed, int level)
+{
+    const int extent = DrawingStore::indexed_extent;
+    drawing_rect r = { std::max(exposed.left, -extent), std::max(exposed.top, -extent), std::min(exposed.right, extent), std::min(exposed.bottom, extent) };
+    drawing_rect blocks;
+    store->renderLevel(level, r, blocks, level_pixels);
+    if(level_pixels.empty()) return;
+    int width = blocks.right - blocks.left;
+    int height = blocks.bottom - blocks.top;
+    QImage image(reinterpret_cast<const uchar *>(level_pixels.data()), width, height, width * 4, QImage::Format_RGBA8888);
+    double size = double(1 << level);
+    QRectF source((r.left - blocks.left * size) / size, (r.top - blocks.top * size) / size, (r.right - r.left) / size, (r.bottom - r.top) / size);
+    painter->drawImage(QRectF(r.left, r.top, r.right - r.left, r.bottom - r.top), image, source);
+}
+
+void DrawingItem::refresh()
+{
+    drawing_rect r;
+    if(store->getBounds(r))
+    {
+        QRectF grown = bounds.united(QRectF(r.left, r.top, r.right - r.left, r.bottom - r.top));
+        if(grown != bounds)
+        {
+            prepareGeometryChange();
+            bounds = grown;
+        }
+    }
+    if(store->takeChanged(r)) update(QRectF(r.left, r.top, r.right - r.left, r.bottom - r.top));
+}
@@ -1,37 +1,78 @@
-#ifndef MAINWINDOW_H
-#define MAINWINDOW_H
-
-#include <QMainWindow>
-#include <QGraphicsScene>
-#include "model.hpp"
-
-namespace Ui {
-class MainWindow;
-}
-
-class MainWindow : public QMainWindow
-{
-    Q_OBJECT
-
-public:
-    explicit MainWindow(QWidget *parent = 0);
-    ~MainWindow();
-    void setColor(int r, int g, int b);
-    void clearScreen();
-    void drawLine2Point(int x1, int y1, int x2, int y2);
-    void drawLinePointAngleLength(int x1, int y1, int length, int angle);
-    void moveTurtle2Point(int x2, int y2);
-    void moveTurtlePointAngleLength(int x1, int y1, int length, int angle);
-
-private slots:
-    void on_pushButton_clicked();
-
-private:
-    Ui::MainWindow *ui;
-    QGraphicsScene *scene;
-    Model * model;
-    QPen *pen;
-    QColor *color;
-};
-
-#endif // MAINWINDOW_H
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <QMainWindow>
+#include <QGraphicsScene>
+#include <QGraphicsItem>
+#include <QTimer>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "model.hpp"
+#include "commandqueue.hpp"
+#include "drawingstore.hpp"
+
+namespace Ui {
+class MainWindow;
+}
+
+class DrawingItem : public QGraphicsItem
+{
+public:
+    explicit DrawingItem(DrawingStore *s);
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+    void refresh();
+
+private:
+    void paintLevel(QPainter *painter, const drawing_rect &r, int level);
+    void paintVisible(QPainter *painter);
+
+    DrawingStore *store;
+    QRectF bounds;
+    std::vector<uint32_t> visible;
+    std::vector<QLine> run;
+    std::vector<uint32_t> level_pixels;
+};
+
+class MainWindow : public QMainWindow, public RenderSink
+{
+    Q_OBJECT
+
+public:
+    explicit MainWindow(QWidget *parent = 0);
+    ~MainWindow();
+    void updateColor(int r, int g, int b);
+    void clearScreen();
+    void drawLine2Point(int x1, int y1, int x2, int y2);
+    void drawLinePointAngleLength(int x1, int y1, int length, int angle);
+    void moveTurtle2Point(int x2, int y2);
+    void moveTurtlePointAngleLength(int x1, int y1, int length, int angle);
+    int getValueFromUser(std::string s);
+    void drawCommands(const render_command * first, size_t count);
+
+private slots:
+    void on_pushButton_clicked();
+    void drainCommands();
+
+private:
+    void finishRun();
+
+    Ui::MainWindow *ui;
+    QGraphicsScene *scene;
+    DrawingStore store;
+    DrawingItem *drawing;
+    CommandQueue * queue;
+    QueueSink * queue_sink;
+    CommandBuffer * buffer;
+    Model * model;
+    std::thread worker;
+    std::atomic<OutputLog *> finished_log;
+    bool running;
+    QString button_text;
+    QTimer *frame_timer;
+    std::vector<render_command> batch;
+    QColor *color;
+};
+
+#endif // MAINWINDOW_H
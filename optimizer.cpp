@@ -0,0 +1,128 @@
+#include "parser.hpp"
+#include <climits>
+
+/*
+Folds two constant operands joined by a multiplicative operator, wrapping around on overflow; returns false
+for the divisions left to the run time, which reports the division by zero and owns the overflowing quotient
+*/
+static bool foldOperator(int first_operand, int op, int last_operand, int & result)
+{
+	if (op == '*')
+	{
+		result = int(unsigned(first_operand) * unsigned(last_operand));
+		return true;
+	}
+	if (last_operand == 0 || (first_operand == INT_MIN && last_operand == -1)) return false;
+	result = first_operand / last_operand;
+	return true;
+}
+
+/*
+Flattens the right-recursive chain into a constant and a sum of signed products, evaluated from left to right.
+The chain a - b + c means a - (b + c), so a binary minus flips the sign of every term after it, while a unary
+minus only applies to the first operand of its own link
+*/
+void AdditiveExpression::optimize(Arena * a)
+{
+	if (optimized) return;
+	optimized = true;
+
+	std::vector<expression_term> collected;
+	int sign = 1;
+	for (AdditiveExpression * link = this; link != nullptr; link = link->has_last_operand ? link->last_operand : nullptr)
+	{
+		bool negated = !(link->unary_operator.type == T_EMPTY) && link->unary_operator.integer_value == '-';
+		addTerm(link->first_operand, negated ? -sign : sign, a, collected);
+
+		if (link->has_last_operand && link->binary_operator.integer_value == '-')
+		{
+			sign = -sign;
+		}
+	}
+	terms = a->copy(collected.data(), collected.size());
+}
+
+/*
+Flattens a multiplicative chain into a product with the given sign. Constant operands multiplying the front
+of the product go to its coefficient, a constant tail is computed unless it divides by zero, and a product
+reduced to a number is added to the constant of the expression; a single parenthesised operand has its terms
+spliced into this expression
+*/
+void AdditiveExpression::addTerm(MultiplicativeExpression * m, int sign, Arena * a, std::vector<expression_term> & t)
+{
+	std::vector<expression_factor> factors;
+	for (; m != nullptr; m = m->has_last_operand ? m->last_operand : nullptr)
+	{
+		expression_factor f = { m->first_operand_type, 0, nullptr, nullptr, nullptr, 0, m->binary_operator.pos };
+		if (m->has_last_operand) f.op = m->binary_operator.integer_value;
+		switch (m->first_operand_type)
+		{
+		case MultiplicativeExpression::M_NUMBER:
+			f.number = m->number.integer_value;
+			break;
+		case MultiplicativeExpression::M_VARIABLE:
+			f.variable = m->variable;
+			break;
+		case MultiplicativeExpression::M_FUNCTION:
+			f.function = m->function;
+			break;
+		case MultiplicativeExpression::M_PARENTHESIS:
+			m->additive_expression_in_parentheses->optimize(a);
+			if (m->additive_expression_in_parentheses->terms.empty())
+			{
+				f.type = MultiplicativeExpression::M_NUMBER;
+				f.number = m->additive_expression_in_parentheses->constant;
+			}
+			else
+			{
+				f.additive_expression_in_parentheses = m->additive_expression_in_parentheses;
+			}
+			break;
+		}
+		factors.push_back(f);
+	}
+
+	while (factors.size() > 1)
+	{
+		expression_factor & first = factors[factors.size() - 2];
+		expression_factor & last = factors.back();
+		if (last.type != MultiplicativeExpression::M_NUMBER) break;
+
+		if (first.type == MultiplicativeExpression::M_NUMBER)
+		{
+			if (!foldOperator(first.number, first.op, last.number, first.number)) break;
+		}
+		else if (last.number != 1)
+		{
+			break;
+		}
+		first.op = 0;
+		factors.pop_back();
+	}
+
+	unsigned coefficient = unsigned(sign);
+	size_t front = 0;
+	while (factors.size() - front > 1 && factors[front].type == MultiplicativeExpression::M_NUMBER && factors[front].op == '*')
+	{
+		coefficient *= unsigned(factors[front].number);
+		front++;
+	}
+
+	if (factors.size() - front == 1 && factors[front].type == MultiplicativeExpression::M_NUMBER)
+	{
+		constant = int(unsigned(constant) + coefficient * unsigned(factors[front].number));
+	}
+	else if (factors.size() - front == 1 && factors[front].type == MultiplicativeExpression::M_PARENTHESIS)
+	{
+		AdditiveExpression * inner = factors[front].additive_expression_in_parentheses;
+		for (expression_term * i = inner->terms.begin(); i != inner->terms.end(); i++)
+		{
+			t.push_back({ int(coefficient * unsigned(i->coefficient)), i->factors });
+		}
+		constant = int(unsigned(constant) + coefficient * unsigned(inner->constant));
+	}
+	else
+	{
+		t.push_back({ int(coefficient), a->copy(factors.data() + front, factors.size() - front) });
+	}
+}
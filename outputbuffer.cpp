@@ -0,0 +1,65 @@
+#include "outputbuffer.hpp"
+#include <algorithm>
+
+/*
+Appends bytes, writing the buffer out whenever it fills
+*/
+void OutputBuffer::write(const char * s, size_t n)
+{
+	while (n > 0)
+	{
+		if (used == data.size()) flush();
+		size_t part = std::min(n, data.size() - used);
+		std::memcpy(data.data() + used, s, part);
+		used += part;
+		s += part;
+		n -= part;
+	}
+}
+
+/*
+Appends an integer in decimal
+*/
+void OutputBuffer::writeDecimal(long long v)
+{
+	char digits[24];
+	int n = 0;
+	unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+	do
+	{
+		digits[n++] = char('0' + u % 10);
+		u /= 10;
+	} while (u > 0);
+	if (v < 0) put('-');
+	while (n > 0) put(digits[--n]);
+}
+
+/*
+Appends the low bytes of an integer, the lowest first
+*/
+void OutputBuffer::writeLittleEndian(uint32_t v, int bytes)
+{
+	for (int i = 0; i < bytes; i++, v >>= 8) put(char(v & 0xff));
+}
+
+/*
+Appends an unsigned integer seven bits at a time, the lowest first, the high bit of a byte telling that more follow
+*/
+void OutputBuffer::writeVarint(uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		put(char(v | 0x80));
+		v >>= 7;
+	}
+	put(char(v));
+}
+
+/*
+Hands the buffered bytes to the stream
+*/
+void OutputBuffer::flush()
+{
+	if (used > 0) out.write(data.data(), std::streamsize(used));
+	used = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+/*
+Buffer in front of an output stream, handing it large blocks instead of the small pieces a sink writes; integers
+are formatted by hand, in decimal, little endian or as varints, without the formatting of the stream
+*/
+class OutputBuffer
+{
+public:
+	explicit OutputBuffer(std::ostream & o, size_t capacity = 1 << 16) : out(o), data(capacity) {}
+	~OutputBuffer() { flush(); }
+	OutputBuffer(const OutputBuffer &) = delete;
+	OutputBuffer & operator=(const OutputBuffer &) = delete;
+
+	void put(char c)
+	{
+		if (used == data.size()) flush();
+		data[used++] = c;
+	}
+	void write(const char * s, size_t n);
+	void write(const char * s) { write(s, std::strlen(s)); }
+	void writeDecimal(long long v);
+	void writeLittleEndian(uint32_t v, int bytes);
+	void writeVarint(uint64_t v);
+	void flush();
+	bool good() const { return bool(out); }
+
+private:
+	std::ostream & out;
+	std::vector<char> data;
+	size_t used = 0;
+};
+
+#endif
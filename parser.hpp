@@ -1,577 +1,688 @@
-#ifndef PARSER_H
-#define PARSER_H
-
-#pragma once
-#include <iostream>
-#include <list> 
-#include <typeinfo>
-#include <chrono>
-#include <thread>
-#include "lexer.hpp"
-#include "context.hpp"
-
-
-/*
-Struct used to return values from function execution
-*/
-struct function_result
-{
-	int integer_value = 0;
-	bool returns_a_value = false;
-	bool is_output = false;
-};
-
-
-
-/*
-Virtual class to represent all statements
-*/
-class Statement
-{
-public:
-	Statement() = default;
-    virtual ~Statement()=0;
-	virtual function_result execute(ProgramContext * pc) = 0;
-};
-
-/*
-Virtual class to represent all statements which can appear inside of a body of a function
-*/
-class InFunctionStatement : public Statement
-{
-public:
-	InFunctionStatement() = default;
-    virtual ~InFunctionStatement()=0;
-	virtual function_result execute(ProgramContext * pc) = 0;
-};
-
-class Function;
-
-/*
-Class representing a function definition statement
-*/
-class FunctionDefinition : public Statement
-{
-public:
-	FunctionDefinition(Token i, int n, std::list<Token> * a, std::list<InFunctionStatement*> * s) : identifier(i), number_of_arguments(n), arguments(a), statementList(s) {}
-    ~FunctionDefinition() { if(number_of_arguments != 0) delete arguments; while (!statementList->empty()) { delete statementList->front(), statementList->pop_front(); } delete statementList; }
-	
-	int getNumberOfArgs() { return number_of_arguments; }
-	std::list<Token> * getArgList() { return arguments; }
-	std::list<InFunctionStatement*> * getStatementList() { return statementList; }
-
-	function_result execute(ProgramContext * pc);
-	void update(std::list<InFunctionStatement*> * s) { this->statementList = s; }
-
-private:
-	Token identifier;
-	int number_of_arguments;
-	std::list<Token> * arguments;
-	std::list<InFunctionStatement*> * statementList;
-
-};
-
-/*
-Class representing a variable
-*/
-class Variable
-{
-public:
-	Variable(Token i) : identifier(i) {}
-	int evaluate(ProgramContext * pc);
-
-private:
-	Token identifier;
-};
-
-/*
-Declaration of a class representing an additive expression
-*/
-class AdditiveExpression;
-
-/*
-Class representing a defined function
-*/
-class Function : public InFunctionStatement
-{
-public:
-	Function(Token i, std::list<AdditiveExpression *> * a) : identifier(i), argument_list(a) {}
-	Function() = default;
-	function_result execute(ProgramContext * pc);
-	~Function();
-
-private:
-	Token identifier;
-    std::list<AdditiveExpression *> * argument_list = nullptr;
-};
-
-/*
-Class representing a multiplicative expression
-*/
-class MultiplicativeExpression
-{
-public:
-	enum { M_NUMBER, M_VARIABLE, M_FUNCTION, M_PARENTHESIS };
-	MultiplicativeExpression() = default;
-	MultiplicativeExpression(Token n) : number(n), first_operand_type(M_NUMBER), has_last_operand(false) {}
-	MultiplicativeExpression(Token n, Token b, MultiplicativeExpression * l) : number(n), binary_operator(b), last_operand(l), first_operand_type(M_NUMBER), has_last_operand(true) {}
-	MultiplicativeExpression(Variable * v) : variable(v), first_operand_type(M_VARIABLE), has_last_operand(false) {}
-	MultiplicativeExpression(Variable * v, Token b, MultiplicativeExpression * l) : variable(v), binary_operator(b), last_operand(l), first_operand_type(M_VARIABLE), has_last_operand(true) {}
-	MultiplicativeExpression(Function * f) : function(f), first_operand_type(M_FUNCTION), has_last_operand(false) {}
-	MultiplicativeExpression(Function * f, Token b, MultiplicativeExpression * l) : function(f), binary_operator(b), last_operand(l), first_operand_type(M_FUNCTION), has_last_operand(true) {}
-	MultiplicativeExpression(AdditiveExpression * aeip) : additive_expression_in_parentheses(aeip), first_operand_type(M_PARENTHESIS), has_last_operand(false) {}
-	MultiplicativeExpression(AdditiveExpression * aeip, Token b, MultiplicativeExpression * l) : additive_expression_in_parentheses(aeip), binary_operator(b), last_operand(l), first_operand_type(M_PARENTHESIS), has_last_operand(true) {}
-	int evaluate(ProgramContext * pc);
-	~MultiplicativeExpression();
-
-private:
-	Token number;
-	Variable * variable;
-	Function * function;
-	AdditiveExpression * additive_expression_in_parentheses;
-	Token binary_operator;
-	MultiplicativeExpression * last_operand;
-    int first_operand_type;
-    bool has_last_operand;
-};
-
-/*
-Definition of a class representing an additive expression
-*/
-class AdditiveExpression
-{
-public:
-	AdditiveExpression() = default;
-	AdditiveExpression(Token u, MultiplicativeExpression * f) : unary_operator(u), first_operand(f), has_last_operand(false) {}
-	AdditiveExpression(Token u, MultiplicativeExpression * f, Token b, AdditiveExpression * l) : unary_operator(u), first_operand(f), binary_operator(b), last_operand(l), has_last_operand(true) {}
-	int evaluate(ProgramContext * pc);
-    ~AdditiveExpression() { delete first_operand; if(has_last_operand) delete last_operand; }
-private:
-	Token unary_operator;
-	MultiplicativeExpression * first_operand;
-	Token binary_operator;
-	AdditiveExpression * last_operand;
-    bool has_last_operand;
-};
-
-class LogicalExpressionSet;
-
-/*
-Class representing a logical expression
-*/
-class LogicalExpression
-{
-public:
-	enum { L_BASE_LOGICAL_VALUE, L_COMPARISON, L_UNARY, L_BRACES };
-	LogicalExpression(AdditiveExpression * f, AdditiveExpression * l, Token b) : has_unary_in_front(false), first_operand(f), last_operand(l), binary_operator(b), logical_type(L_COMPARISON) {}
-	LogicalExpression(bool h, LogicalExpressionSet * s) : has_unary_in_front(h), logical_expression_set(s), logical_type(L_UNARY) {}
-	LogicalExpression(LogicalExpressionSet * s) : has_unary_in_front(false), logical_expression_set(s), logical_type(L_BRACES) {}
-	LogicalExpression(bool l) : has_unary_in_front(false), logical_value(l), logical_type(L_BASE_LOGICAL_VALUE) {}
-	bool evaluate(ProgramContext * pc);
-	~LogicalExpression();
-
-private:
-    bool has_unary_in_front;
-	AdditiveExpression * first_operand;
-	AdditiveExpression * last_operand;
-	Token binary_operator;
-	LogicalExpressionSet * logical_expression_set;
-	bool logical_value;
-    int logical_type;
-};
-
-/*
-Class representing a set of logical expressions
-*/
-class LogicalExpressionSet
-{
-public:
-	LogicalExpressionSet(LogicalExpression * f) : first_operand(f), has_last_operand(false) {}
-	LogicalExpressionSet(LogicalExpression * f, Token b, LogicalExpressionSet * l) : first_operand(f), binary_operator(b), last_operand(l), has_last_operand(true) {}
-	bool evaluate(ProgramContext * pc);
-    ~LogicalExpressionSet() { delete first_operand; if(has_last_operand) delete last_operand; }
-
-private:
-	LogicalExpression * first_operand;
-	Token binary_operator;
-	LogicalExpressionSet * last_operand;
-    bool has_last_operand;
-};
-
-/*
-Class to represent a forward statement
-*/
-class Forward : public InFunctionStatement
-{
-public:
-	Forward(AdditiveExpression * a) : move_by_value(a) {}
-	function_result execute(ProgramContext * pc);
-	~Forward() { delete move_by_value; }
-
-private:
-	AdditiveExpression * move_by_value;
-};
-
-/*
-Class to represent a backward statement
-*/
-class Backward : public InFunctionStatement
-{
-public:
-	Backward(AdditiveExpression * a) : move_by_value(a) {}
-	function_result execute(ProgramContext * pc);
-	~Backward() { delete move_by_value; }
-
-private:
-	AdditiveExpression * move_by_value;
-};
-
-/*
-Class to represent a right turn statement
-*/
-class RightTurn : public InFunctionStatement
-{
-public:
-	RightTurn(AdditiveExpression * a) : move_by_value(a) {}
-	function_result execute(ProgramContext * pc);
-	~RightTurn() { delete move_by_value; }
-
-private:
-	AdditiveExpression * move_by_value;
-};
-
-/*
-Class to represent a left turn statement
-*/
-class LeftTurn : public InFunctionStatement
-{
-public:
-	LeftTurn(AdditiveExpression * a) : move_by_value(a) {}
-	function_result execute(ProgramContext * pc);
-	~LeftTurn() { delete move_by_value; }
-
-private:
-
-	AdditiveExpression * move_by_value;
-};
-
-/*
-Class to represent a move by vector statement
-*/
-class MoveByVector : public InFunctionStatement
-{
-public:
-	MoveByVector(AdditiveExpression * x, AdditiveExpression * y) : x_value(x), y_value(y) {}
-	function_result execute(ProgramContext * pc);
-	~MoveByVector() { delete x_value; delete y_value; }
-
-private:
-	AdditiveExpression * x_value;
-	AdditiveExpression * y_value;
-};
-
-/*
-Class to represent a move to position statement
-*/
-class MoveToPosition : public InFunctionStatement
-{
-public:
-	MoveToPosition(AdditiveExpression * x, AdditiveExpression * y) : x_value(x), y_value(y) {}
-	function_result execute(ProgramContext * pc);
-	~MoveToPosition() { delete x_value; delete y_value; }
-
-private:
-	AdditiveExpression * x_value;
-	AdditiveExpression * y_value;
-};
-
-/*
-Class to represent a set heading statement
-*/
-class SetHeading : public InFunctionStatement
-{
-public:
-	SetHeading(AdditiveExpression * h) : heading_value(h) {}
-	function_result execute(ProgramContext * pc);
-	~SetHeading() { delete heading_value; }
-
-private:
-	AdditiveExpression * heading_value;
-};
-
-/*
-Class to represent a turtle go home statement
-*/
-class TurtleGoHome : public InFunctionStatement
-{
-public:
-	TurtleGoHome() {}
-	function_result execute(ProgramContext * pc);
-};
-
-/*
-Class to represent a get x statement
-*/
-class GetX : public Function
-{
-public:
-	GetX() {}
-	function_result execute(ProgramContext * pc);
-};
-
-/*
-Class to represent a get y statement
-*/
-class GetY  : public Function
-{
-public:
-	GetY() {}
-	function_result execute(ProgramContext * pc);
-};
-
-/*
-Class to represent a get heading statement
-*/
-class GetHeading : public Function
-{
-public:
-	GetHeading() {}
-	function_result execute(ProgramContext * pc);
-};
-
-/*
-Class to represent a clear screen statement
-*/
-class CleanScreen : public InFunctionStatement
-{
-public:
-	CleanScreen() {}
-	function_result execute(ProgramContext * pc);
-};
-
-/*
-Class to represent a pen up statement
-*/
-class PenUp : public InFunctionStatement
-{
-public:
-	PenUp() {}
-	function_result execute(ProgramContext * pc);
-};
-
-/*
-Class to represent a pen down statement
-*/
-class PenDown : public InFunctionStatement
-{
-public:
-	PenDown() {}
-	function_result execute(ProgramContext * pc);
-};
-
-/*
-Class to represent a set color statement
-*/
-class SetColor : public InFunctionStatement
-{
-public:
-	SetColor(AdditiveExpression * r, AdditiveExpression * g, AdditiveExpression * b) : red(r), green(g), blue(b) {}
-	function_result execute(ProgramContext * pc);
-	~SetColor() { delete red; delete green; delete blue; }
-
-private:
-	AdditiveExpression * red;
-	AdditiveExpression * green;
-	AdditiveExpression * blue;
-};
-
-/*
-Class to represent an output statement
-*/
-class Output : public InFunctionStatement
-{
-public:
-	Output(AdditiveExpression * a) : additive_exp(a) {}
-	function_result execute(ProgramContext * pc);
-	int evaluate(ProgramContext * pc);
-	~Output() { delete additive_exp; }
-
-private:
-	AdditiveExpression * additive_exp;
-};
-
-/*
-Class to represent a print statement
-*/
-class Print : public InFunctionStatement
-{
-public:
-	Print(AdditiveExpression * a) : additive_exp(a), is_string(false) {}
-	Print(std::string s) : string_exp(s), is_string(true) {}
-	function_result execute(ProgramContext * pc);
-    ~Print() { if(!is_string) delete additive_exp; }
-
-private:
-	AdditiveExpression * additive_exp;
-	std::string string_exp;
-	bool is_string;
-};
-
-/*
-Class to represent a scan statement
-*/
-class Scan : public InFunctionStatement
-{
-public:
-	Scan(Token i) : identifier(i) {}
-	function_result execute(ProgramContext * pc);
-
-private:
-	Token identifier;
-};
-
-/*
-Class to represent a make statement
-*/
-class Make : public InFunctionStatement
-{
-public:
-	Make(Token i, AdditiveExpression * a) : identifier(i), assigned_value(a) {}
-	function_result execute(ProgramContext * pc);
-	~Make() { delete assigned_value; }
-
-private:
-	Token identifier;
-	AdditiveExpression * assigned_value;
-};
-
-/*
-Class to represent a make statement
-*/
-class LocalMakeScan : public InFunctionStatement
-{
-public:
-    LocalMakeScan(Token i, AdditiveExpression * a) : isScan(false), identifier(i), assigned_value(a) {}
-    LocalMakeScan(Token i) : isScan(true), identifier(i) {}
-	function_result execute(ProgramContext * pc);
-    ~LocalMakeScan() { if(!isScan) delete assigned_value; }
-
-private:
-	bool isScan;
-	Token identifier;
-	AdditiveExpression * assigned_value;
-};
-
-/*
-Class to represent an if statement
-*/
-class IfStatement : public InFunctionStatement
-{
-public:
-	IfStatement(LogicalExpressionSet * c, std::list<Statement*> * s) : condition(c), statementList(s) {}
-	function_result execute(ProgramContext * pc);
-	~IfStatement() { delete condition; while (!statementList->empty()) { delete statementList->front(), statementList->pop_front(); } delete statementList; }
-
-private:
-	LogicalExpressionSet * condition;
-	std::list<Statement*> * statementList;
-};
-
-/*
-Class to represent a repeat statement
-*/
-class RepeatStatement : public InFunctionStatement
-{
-public:
-	RepeatStatement(AdditiveExpression * n, std::list<Statement*> * s) : number_of_repetitions(n), statementList(s) {}
-	function_result execute(ProgramContext * pc);
-	~RepeatStatement() { delete number_of_repetitions; while (!statementList->empty()) { delete statementList->front(), statementList->pop_front(); } delete statementList; }
-private:
-	AdditiveExpression * number_of_repetitions;
-	std::list<Statement*> * statementList;
-};
-
-/*
-Class to represent a turtle sleep statement
-*/
-class TurtleSleep : public InFunctionStatement
-{
-public:
-    TurtleSleep(AdditiveExpression * t) : time_to_sleep(t) {}
-	function_result execute(ProgramContext * pc);
-    ~TurtleSleep() { delete time_to_sleep; }
-
-private:
-    AdditiveExpression * time_to_sleep;
-};
-
-/*
-Class to represent the starting statement
-*/
-class StartingStatement
-{
-public:
-	StartingStatement() = default;
-	void addStatement(Statement * s);
-	void execute(ProgramContext * pc);
-    ~StartingStatement();
-	std::list<Statement*> * getFunDefs();
-
-private:
-	std::list<Statement*> statementList;
-	
-};
-
-/*
-Class to represent the parser
-*/
-class Parser
-{
-public:
-    Parser(Lexer * l, ProgramContext * p) : lex(l), pc(p) {}
-    Parser() = default;
-	StartingStatement* doStartingStatement();
-
-private:
-	Lexer * lex;
-    ProgramContext * pc;
-	Token buf;
-    FunctionSymbolTable fun;
-
-	void getNextToken();
-	bool isFunction(Token identifier);
-	AdditiveExpression * doAdditiveExpression();
-	MultiplicativeExpression * doMultiplicativeExpression();
-	LogicalExpressionSet * doLogicalExpressionSet();
-	LogicalExpression * doLogicalExpression();
-	Statement * doStatement();
-	FunctionDefinition * doFunctionDefinition();
-	InFunctionStatement * doInFunctionStatement();
-	Forward * doForward();
-	Backward * doBackward();
-	RightTurn * doRightTurn();
-	LeftTurn * doLeftTurn();
-	MoveByVector * doMoveByVector();
-	MoveToPosition * doMoveToPosition();
-	SetHeading * doSetHeading();
-	TurtleGoHome * doTurtleGoHome();
-	GetX * doGetX();
-	GetY * doGetY();
-	GetHeading * doGetHeading();
-	CleanScreen * doCleanScreen();
-	PenUp * doPenUp();
-	PenDown * doPenDown();
-	SetColor * doSetColor();
-	Output * doOutput();
-	Print * doPrint();
-	Scan * doScan();
-	Make * doMake();
-	LocalMakeScan * doLocalMakeScan();
-	IfStatement * doIfStatement();
-	RepeatStatement * doRepeatStatement();
-	TurtleSleep * doTurtleSleep();
-	Variable * doVariable();
-	Function * doFunction();
-};
-
-#endif
+#ifndef PARSER_H
+#define PARSER_H
+
+#pragma once
+#include <iostream>
+#include <list> 
+#include <vector>
+#include <cstdint>
+#include <typeinfo>
+#include <chrono>
+#include <thread>
+#include "lexer.hpp"
+#include "context.hpp"
+#include "bytecode.hpp"
+#include "arena.hpp"
+
+
+class Function;
+class FunctionDefinition;
+
+/*
+Struct used to return values from function execution; tail_call is set by a call in tail position
+of a function body, which is left to the function being executed to perform
+*/
+struct function_result
+{
+	int integer_value = 0;
+	bool returns_a_value = false;
+	bool is_output = false;
+	Function * tail_call = nullptr;
+};
+
+
+
+/*
+Functions being analysed for purity, outermost first, which are assumed pure while their calls recurse, and the
+outermost of them such an assumption was made for since the analysis of the innermost one started
+*/
+struct purity_analysis
+{
+	std::vector<FunctionDefinition *> in_progress;
+	size_t assumed = SIZE_MAX;
+};
+
+/*
+State of the purity analysis of a function body: the variables a statement may read, which are the parameters
+and the local variables made before it, and the functions being analysed
+*/
+struct purity_check
+{
+	ProgramContext * pc;
+	std::vector<SymbolId> readable;
+	purity_analysis * analysis;
+};
+
+/*
+Virtual class to represent all statements
+*/
+class Statement
+{
+public:
+	Statement() = default;
+    virtual ~Statement()=0;
+	virtual function_result execute(ProgramContext * pc) = 0;
+	virtual void compile(Compiler * c) = 0;
+};
+
+/*
+Virtual class to represent all statements which can appear inside of a body of a function
+*/
+class InFunctionStatement : public Statement
+{
+public:
+	InFunctionStatement() = default;
+    virtual ~InFunctionStatement()=0;
+	virtual function_result execute(ProgramContext * pc) = 0;
+	virtual void compile(Compiler * c) = 0;
+	virtual void markTailCall() {}
+	virtual bool isPure(purity_check &) { return false; }
+};
+
+/*
+Class representing a function definition statement
+*/
+class FunctionDefinition : public Statement
+{
+public:
+	FunctionDefinition(Token i, Span<SymbolId> a) : identifier(i), number_of_arguments(int(a.size())), arguments(a) {}
+    ~FunctionDefinition() { delete chunk; }
+	
+	int getNumberOfArgs() { return number_of_arguments; }
+	Span<SymbolId> getArgList() { return arguments; }
+	Span<InFunctionStatement*> getStatementList() { return statementList; }
+	Chunk * getChunk();
+
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	void update(Span<InFunctionStatement*> s);
+	bool isPure(ProgramContext * pc);
+	bool isPure(ProgramContext * pc, purity_analysis & analysis);
+
+private:
+	Token identifier;
+	int number_of_arguments;
+	Span<SymbolId> arguments;
+	Span<InFunctionStatement*> statementList;
+	Chunk * chunk = nullptr;
+	bool pure = false;
+	int purity_generation = -1;
+
+};
+
+/*
+Class representing a variable
+*/
+class Variable
+{
+public:
+	Variable(Token i) : identifier(i) {}
+	int evaluate(ProgramContext * pc);
+	void compile(Compiler * c);
+	bool isPure(const purity_check & c);
+
+private:
+	Token identifier;
+};
+
+/*
+Declaration of a class representing an additive expression
+*/
+class AdditiveExpression;
+
+/*
+Class representing a defined function
+*/
+class Function : public InFunctionStatement
+{
+public:
+	Function(Token i, Span<AdditiveExpression *> a) : identifier(i), argument_list(a) {}
+	Function() = default;
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	virtual void compileExpression(Compiler * c);
+	void markTailCall() { tail_call = true; }
+	const position & getPosition() const { return identifier.pos; }
+	bool isPure(purity_check & c);
+
+private:
+	void evaluateArguments(ProgramContext * pc, std::vector<int> & values);
+	function_result call(ProgramContext * pc, std::vector<int> & values);
+	function_result invoke(ProgramContext * pc, std::vector<int> & values);
+
+	Token identifier;
+	Span<AdditiveExpression *> argument_list;
+	bool tail_call = false;
+};
+
+/*
+Class representing a multiplicative expression
+*/
+class MultiplicativeExpression
+{
+public:
+	enum { M_NUMBER, M_VARIABLE, M_FUNCTION, M_PARENTHESIS };
+	MultiplicativeExpression() = default;
+	MultiplicativeExpression(Token n) : number(n), first_operand_type(M_NUMBER), has_last_operand(false) {}
+	MultiplicativeExpression(Token n, Token b, MultiplicativeExpression * l) : number(n), binary_operator(b), last_operand(l), first_operand_type(M_NUMBER), has_last_operand(true) {}
+	MultiplicativeExpression(Variable * v) : variable(v), first_operand_type(M_VARIABLE), has_last_operand(false) {}
+	MultiplicativeExpression(Variable * v, Token b, MultiplicativeExpression * l) : variable(v), binary_operator(b), last_operand(l), first_operand_type(M_VARIABLE), has_last_operand(true) {}
+	MultiplicativeExpression(Function * f) : function(f), first_operand_type(M_FUNCTION), has_last_operand(false) {}
+	MultiplicativeExpression(Function * f, Token b, MultiplicativeExpression * l) : function(f), binary_operator(b), last_operand(l), first_operand_type(M_FUNCTION), has_last_operand(true) {}
+	MultiplicativeExpression(AdditiveExpression * aeip) : additive_expression_in_parentheses(aeip), first_operand_type(M_PARENTHESIS), has_last_operand(false) {}
+	MultiplicativeExpression(AdditiveExpression * aeip, Token b, MultiplicativeExpression * l) : additive_expression_in_parentheses(aeip), binary_operator(b), last_operand(l), first_operand_type(M_PARENTHESIS), has_last_operand(true) {}
+	friend class AdditiveExpression;
+
+private:
+	Token number;
+	Variable * variable;
+	Function * function;
+	AdditiveExpression * additive_expression_in_parentheses;
+	Token binary_operator;
+	MultiplicativeExpression * last_operand;
+    int first_operand_type;
+    bool has_last_operand;
+};
+
+/*
+Operand of a flattened product; op joins it to the rest of the product, which is evaluated first
+*/
+struct expression_factor
+{
+	int type;
+	int number;
+	Variable * variable;
+	Function * function;
+	AdditiveExpression * additive_expression_in_parentheses;
+	int op;
+	position op_position;
+};
+
+/*
+Signed product of a flattened additive expression, the coefficient holding its folded constant factors
+*/
+struct expression_term
+{
+	int coefficient;
+	Span<expression_factor> factors;
+};
+
+/*
+Definition of a class representing an additive expression
+*/
+class AdditiveExpression
+{
+public:
+	AdditiveExpression() = default;
+	AdditiveExpression(Token u, MultiplicativeExpression * f) : unary_operator(u), first_operand(f), has_last_operand(false) {}
+	AdditiveExpression(Token u, MultiplicativeExpression * f, Token b, AdditiveExpression * l) : unary_operator(u), first_operand(f), binary_operator(b), last_operand(l), has_last_operand(true) {}
+	void optimize(Arena * a);
+	int evaluate(ProgramContext * pc);
+	void compile(Compiler * c);
+	bool isPure(purity_check & c);
+
+private:
+	void addTerm(MultiplicativeExpression * m, int sign, Arena * a, std::vector<expression_term> & t);
+
+	Token unary_operator;
+	MultiplicativeExpression * first_operand;
+	Token binary_operator;
+	AdditiveExpression * last_operand;
+    bool has_last_operand;
+	bool optimized = false;
+	int constant = 0;
+	Span<expression_term> terms;
+};
+
+class LogicalExpressionSet;
+
+/*
+Class representing a logical expression
+*/
+class LogicalExpression
+{
+public:
+	enum { L_BASE_LOGICAL_VALUE, L_COMPARISON, L_UNARY, L_BRACES };
+	LogicalExpression(AdditiveExpression * f, AdditiveExpression * l, Token b) : has_unary_in_front(false), first_operand(f), last_operand(l), binary_operator(b), logical_type(L_COMPARISON) {}
+	LogicalExpression(bool h, LogicalExpressionSet * s) : has_unary_in_front(h), logical_expression_set(s), logical_type(L_UNARY) {}
+	LogicalExpression(LogicalExpressionSet * s) : has_unary_in_front(false), logical_expression_set(s), logical_type(L_BRACES) {}
+	LogicalExpression(bool l) : has_unary_in_front(false), logical_value(l), logical_type(L_BASE_LOGICAL_VALUE) {}
+	bool evaluate(ProgramContext * pc);
+	void compile(Compiler * c);
+	bool isPure(purity_check & c);
+
+private:
+    bool has_unary_in_front;
+	AdditiveExpression * first_operand;
+	AdditiveExpression * last_operand;
+	Token binary_operator;
+	LogicalExpressionSet * logical_expression_set;
+	bool logical_value;
+    int logical_type;
+};
+
+/*
+Class representing a set of logical expressions
+*/
+class LogicalExpressionSet
+{
+public:
+	LogicalExpressionSet(LogicalExpression * f) : first_operand(f), has_last_operand(false) {}
+	LogicalExpressionSet(LogicalExpression * f, Token b, LogicalExpressionSet * l) : first_operand(f), binary_operator(b), last_operand(l), has_last_operand(true) {}
+	bool evaluate(ProgramContext * pc);
+	void compile(Compiler * c);
+	bool isPure(purity_check & c);
+
+private:
+	LogicalExpression * first_operand;
+	Token binary_operator;
+	LogicalExpressionSet * last_operand;
+    bool has_last_operand;
+};
+
+/*
+Class to represent a forward statement
+*/
+class Forward : public InFunctionStatement
+{
+public:
+	Forward(AdditiveExpression * a) : move_by_value(a) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	AdditiveExpression * move_by_value;
+};
+
+/*
+Class to represent a backward statement
+*/
+class Backward : public InFunctionStatement
+{
+public:
+	Backward(AdditiveExpression * a) : move_by_value(a) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	AdditiveExpression * move_by_value;
+};
+
+/*
+Class to represent a right turn statement
+*/
+class RightTurn : public InFunctionStatement
+{
+public:
+	RightTurn(AdditiveExpression * a) : move_by_value(a) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	AdditiveExpression * move_by_value;
+};
+
+/*
+Class to represent a left turn statement
+*/
+class LeftTurn : public InFunctionStatement
+{
+public:
+	LeftTurn(AdditiveExpression * a) : move_by_value(a) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+
+	AdditiveExpression * move_by_value;
+};
+
+/*
+Class to represent a move by vector statement
+*/
+class MoveByVector : public InFunctionStatement
+{
+public:
+	MoveByVector(AdditiveExpression * x, AdditiveExpression * y) : x_value(x), y_value(y) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	AdditiveExpression * x_value;
+	AdditiveExpression * y_value;
+};
+
+/*
+Class to represent a move to position statement
+*/
+class MoveToPosition : public InFunctionStatement
+{
+public:
+	MoveToPosition(AdditiveExpression * x, AdditiveExpression * y) : x_value(x), y_value(y) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	AdditiveExpression * x_value;
+	AdditiveExpression * y_value;
+};
+
+/*
+Class to represent a set heading statement
+*/
+class SetHeading : public InFunctionStatement
+{
+public:
+	SetHeading(AdditiveExpression * h) : heading_value(h) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	AdditiveExpression * heading_value;
+};
+
+/*
+Class to represent a turtle go home statement
+*/
+class TurtleGoHome : public InFunctionStatement
+{
+public:
+	TurtleGoHome() {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+};
+
+/*
+Class to represent a get x statement
+*/
+class GetX : public Function
+{
+public:
+	GetX() {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	void compileExpression(Compiler * c);
+	bool isPure(purity_check &) { return false; }
+};
+
+/*
+Class to represent a get y statement
+*/
+class GetY  : public Function
+{
+public:
+	GetY() {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	void compileExpression(Compiler * c);
+	bool isPure(purity_check &) { return false; }
+};
+
+/*
+Class to represent a get heading statement
+*/
+class GetHeading : public Function
+{
+public:
+	GetHeading() {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	void compileExpression(Compiler * c);
+	bool isPure(purity_check &) { return false; }
+};
+
+/*
+Class to represent a clear screen statement
+*/
+class CleanScreen : public InFunctionStatement
+{
+public:
+	CleanScreen() {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+};
+
+/*
+Class to represent a pen up statement
+*/
+class PenUp : public InFunctionStatement
+{
+public:
+	PenUp() {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+};
+
+/*
+Class to represent a pen down statement
+*/
+class PenDown : public InFunctionStatement
+{
+public:
+	PenDown() {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+};
+
+/*
+Class to represent a set color statement
+*/
+class SetColor : public InFunctionStatement
+{
+public:
+	SetColor(AdditiveExpression * r, AdditiveExpression * g, AdditiveExpression * b) : red(r), green(g), blue(b) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	AdditiveExpression * red;
+	AdditiveExpression * green;
+	AdditiveExpression * blue;
+};
+
+/*
+Class to represent an output statement
+*/
+class Output : public InFunctionStatement
+{
+public:
+	Output(AdditiveExpression * a) : additive_exp(a) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	int evaluate(ProgramContext * pc);
+	bool isPure(purity_check & c);
+
+private:
+	AdditiveExpression * additive_exp;
+};
+
+/*
+Class to represent a print statement
+*/
+class Print : public InFunctionStatement
+{
+public:
+	Print(AdditiveExpression * a) : additive_exp(a), is_string(false) {}
+	Print(std::string s) : string_exp(s), is_string(true) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	AdditiveExpression * additive_exp;
+	std::string string_exp;
+	bool is_string;
+};
+
+/*
+Class to represent a scan statement
+*/
+class Scan : public InFunctionStatement
+{
+public:
+	Scan(Token i) : identifier(i) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	Token identifier;
+};
+
+/*
+Class to represent a make statement
+*/
+class Make : public InFunctionStatement
+{
+public:
+	Make(Token i, AdditiveExpression * a) : identifier(i), assigned_value(a) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+	Token identifier;
+	AdditiveExpression * assigned_value;
+};
+
+/*
+Class to represent a make statement
+*/
+class LocalMakeScan : public InFunctionStatement
+{
+public:
+    LocalMakeScan(Token i, AdditiveExpression * a) : isScan(false), identifier(i), assigned_value(a) {}
+    LocalMakeScan(Token i) : isScan(true), identifier(i) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	bool isPure(purity_check & c);
+
+private:
+	bool isScan;
+	Token identifier;
+	AdditiveExpression * assigned_value;
+};
+
+/*
+Class to represent an if statement
+*/
+class IfStatement : public InFunctionStatement
+{
+public:
+	IfStatement(LogicalExpressionSet * c, Span<InFunctionStatement*> s) : condition(c), statementList(s) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	void markTailCall();
+	bool isPure(purity_check & c);
+
+private:
+	LogicalExpressionSet * condition;
+	Span<InFunctionStatement*> statementList;
+};
+
+/*
+Class to represent a repeat statement
+*/
+class RepeatStatement : public InFunctionStatement
+{
+public:
+	RepeatStatement(AdditiveExpression * n, Span<InFunctionStatement*> s, position p) : number_of_repetitions(n), statementList(s), pos(p) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+	bool isPure(purity_check & c);
+private:
+	AdditiveExpression * number_of_repetitions;
+	Span<InFunctionStatement*> statementList;
+	position pos;
+};
+
+/*
+Class to represent a turtle sleep statement
+*/
+class TurtleSleep : public InFunctionStatement
+{
+public:
+    TurtleSleep(AdditiveExpression * t, position p) : time_to_sleep(t), pos(p) {}
+	function_result execute(ProgramContext * pc);
+	void compile(Compiler * c);
+
+private:
+    AdditiveExpression * time_to_sleep;
+	position pos;
+};
+
+/*
+Class to represent the starting statement; all nodes parsed for it, except function definitions,
+are allocated in its arena and released together with it
+*/
+class StartingStatement
+{
+public:
+	StartingStatement() = default;
+	void addStatement(Statement * s);
+	bool execute(ProgramContext * pc, RuntimeError & error);
+	Chunk * compile();
+	Arena * getArena() { return &arena; }
+
+private:
+	std::vector<Statement*> statementList;
+	Arena arena;
+	
+};
+
+/*
+Class to represent the parser; nodes are allocated in the arena of the starting statement being parsed,
+function definitions and their bodies in the long-lived arena of definitions since they outlive it
+*/
+class Parser
+{
+public:
+    Parser(Lexer * l, ProgramContext * p, Arena * d) : lex(l), pc(p), definitions(d) {}
+    Parser() = default;
+	StartingStatement* doStartingStatement();
+
+private:
+	Lexer * lex;
+    ProgramContext * pc;
+	Arena * arena = nullptr;
+	Arena * definitions = nullptr;
+	Token buf;
+    FunctionSymbolTable fun;
+	std::vector<InFunctionStatement*> pending_statements;
+
+	void getNextToken();
+	bool isFunction(Token identifier);
+	AdditiveExpression * doAdditiveExpression();
+	AdditiveExpression * doAdditiveChain();
+	MultiplicativeExpression * doMultiplicativeExpression();
+	LogicalExpressionSet * doLogicalExpressionSet();
+	LogicalExpression * doLogicalExpression();
+	Statement * doStatement();
+	FunctionDefinition * doFunctionDefinition();
+	InFunctionStatement * doInFunctionStatement();
+	Span<InFunctionStatement*> takeStatements(size_t first);
+	Forward * doForward();
+	Backward * doBackward();
+	RightTurn * doRightTurn();
+	LeftTurn * doLeftTurn();
+	MoveByVector * doMoveByVector();
+	MoveToPosition * doMoveToPosition();
+	SetHeading * doSetHeading();
+	TurtleGoHome * doTurtleGoHome();
+	GetX * doGetX();
+	GetY * doGetY();
+	GetHeading * doGetHeading();
+	CleanScreen * doCleanScreen();
+	PenUp * doPenUp();
+	PenDown * doPenDown();
+	SetColor * doSetColor();
+	Output * doOutput();
+	Print * doPrint();
+	Scan * doScan();
+	Make * doMake();
+	LocalMakeScan * doLocalMakeScan();
+	IfStatement * doIfStatement();
+	RepeatStatement * doRepeatStatement();
+	TurtleSleep * doTurtleSleep();
+	Variable * doVariable();
+	Function * doFunction();
+};
+
+#endif
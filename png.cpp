@@ -0,0 +1,270 @@
+#include "png.hpp"
+#include <vector>
+#include <cstdlib>
+
+/*
+Table of the CRC-32 used by the PNG chunks, built once
+*/
+struct crc_table
+{
+	crc_table()
+	{
+		for (uint32_t n = 0; n < 256; n++)
+		{
+			uint32_t c = n;
+			for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+			entries[n] = c;
+		}
+	}
+
+	uint32_t update(uint32_t crc, const uint8_t * data, size_t n) const
+	{
+		for (size_t i = 0; i < n; i++) crc = entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		return crc;
+	}
+
+	uint32_t entries[256];
+};
+
+/*
+Writes a chunk of the PNG file: its length, type, data and CRC
+*/
+static void writeChunk(std::ostream & out, const char * type, const uint8_t * data, size_t n)
+{
+	static const crc_table table;
+	uint8_t header[8] = { uint8_t(n >> 24), uint8_t(n >> 16), uint8_t(n >> 8), uint8_t(n), uint8_t(type[0]), uint8_t(type[1]), uint8_t(type[2]), uint8_t(type[3]) };
+	uint32_t crc = table.update(0xffffffffu, header + 4, 4);
+	crc = table.update(crc, data, n) ^ 0xffffffffu;
+	uint8_t trailer[4] = { uint8_t(crc >> 24), uint8_t(crc >> 16), uint8_t(crc >> 8), uint8_t(crc) };
+
+	out.write(reinterpret_cast<const char *>(header), 8);
+	out.write(reinterpret_cast<const char *>(data), std::streamsize(n));
+	out.write(reinterpret_cast<const char *>(trailer), 4);
+}
+
+/*
+Compressor of the image data into a zlib stream of a single deflate block with the fixed Huffman codes. Matches are
+only looked for at the distances which repeat in a drawing: the previous byte, the previous pixel and the pixel above,
+which is enough for the large areas of one color, and the compressed data is written in IDAT chunks as it grows
+*/
+class Deflater
+{
+public:
+	Deflater(std::ostream & o, size_t s) : out(o), stride(s)
+	{
+		bytes.push_back(0x78);
+		bytes.push_back(0x01);
+		putBits(1, 1);
+		putBits(1, 2);
+	}
+
+	/*
+	Compresses one filtered row, matching against the row before it
+	*/
+	void addRow(const std::vector<uint8_t> & previous, const std::vector<uint8_t> & row)
+	{
+		window.assign(previous.begin(), previous.end());
+		window.insert(window.end(), row.begin(), row.end());
+		size_t begin = previous.size();
+		size_t end = window.size();
+		updateAdler(row.data(), row.size());
+
+		static const size_t distances[] = { 1, 4, 0 };
+		size_t i = begin;
+		while (i < end)
+		{
+			size_t best_length = 0;
+			size_t best_distance = 0;
+			for (size_t k = 0; k < 3; k++)
+			{
+				size_t d = distances[k] == 0 ? stride : distances[k];
+				if (d > i || d > 32768) continue;
+				size_t length = 0;
+				while (length < 258 && i + length < end && window[i + length] == window[i + length - d]) length++;
+				if (length > best_length)
+				{
+					best_length = length;
+					best_distance = d;
+				}
+			}
+
+			if (best_length >= 3)
+			{
+				putLength(int(best_length));
+				putDistance(int(best_distance));
+				i += best_length;
+			}
+			else
+			{
+				putLiteral(window[i]);
+				i++;
+			}
+		}
+		if (bytes.size() >= chunk_size) flushChunk();
+	}
+
+	/*
+	Ends the block and the zlib stream and writes the last chunk
+	*/
+	void finish()
+	{
+		putLiteral(256);
+		if (bit_count > 0) bytes.push_back(uint8_t(bit_buffer));
+		bit_buffer = 0;
+		bit_count = 0;
+		uint32_t adler = (adler_b << 16) | adler_a;
+		bytes.push_back(uint8_t(adler >> 24));
+		bytes.push_back(uint8_t(adler >> 16));
+		bytes.push_back(uint8_t(adler >> 8));
+		bytes.push_back(uint8_t(adler));
+		flushChunk();
+	}
+
+private:
+	void putBits(uint32_t value, int n)
+	{
+		bit_buffer |= value << bit_count;
+		bit_count += n;
+		while (bit_count >= 8)
+		{
+			bytes.push_back(uint8_t(bit_buffer));
+			bit_buffer >>= 8;
+			bit_count -= 8;
+		}
+	}
+
+	/*
+	Writes a Huffman code, which deflate stores from its most significant bit
+	*/
+	void putCode(uint32_t code, int n)
+	{
+		uint32_t reversed = 0;
+		for (int i = 0; i < n; i++) reversed |= ((code >> i) & 1) << (n - 1 - i);
+		putBits(reversed, n);
+	}
+
+	void putLiteral(int literal)
+	{
+		if (literal < 144) putCode(0x30 + uint32_t(literal), 8);
+		else if (literal < 256) putCode(0x190 + uint32_t(literal - 144), 9);
+		else if (literal < 280) putCode(uint32_t(literal - 256), 7);
+		else putCode(0xc0 + uint32_t(literal - 280), 8);
+	}
+
+	void putLength(int length)
+	{
+		static const int base[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		static const int extra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		int code = 28;
+		while (base[code] > length) code--;
+		putLiteral(257 + code);
+		putBits(uint32_t(length - base[code]), extra[code]);
+	}
+
+	void putDistance(int distance)
+	{
+		static const int base[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		static const int extra[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+		int code = 29;
+		while (base[code] > distance) code--;
+		putCode(uint32_t(code), 5);
+		putBits(uint32_t(distance - base[code]), extra[code]);
+	}
+
+	void updateAdler(const uint8_t * data, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			adler_a = (adler_a + data[i]) % 65521;
+			adler_b = (adler_b + adler_a) % 65521;
+		}
+	}
+
+	void flushChunk()
+	{
+		if (bytes.empty()) return;
+		writeChunk(out, "IDAT", bytes.data(), bytes.size());
+		bytes.clear();
+	}
+
+	static const size_t chunk_size = 1 << 16;
+	std::ostream & out;
+	size_t stride;
+	std::vector<uint8_t> window;
+	std::vector<uint8_t> bytes;
+	uint32_t bit_buffer = 0;
+	int bit_count = 0;
+	uint32_t adler_a = 1;
+	uint32_t adler_b = 0;
+};
+
+/*
+Filters a row for compression with the filter making its bytes smallest: none, the difference with the pixel
+on the left or the difference with the pixel above
+*/
+static void filterRow(const std::vector<uint8_t> & above, const std::vector<uint8_t> & current, std::vector<uint8_t> & row)
+{
+	size_t n = current.size();
+	long sums[3] = { 0, 0, 0 };
+	for (size_t i = 0; i < n; i++)
+	{
+		sums[0] += std::abs(int8_t(current[i]));
+		sums[1] += std::abs(int8_t(uint8_t(current[i] - (i >= 4 ? current[i - 4] : 0))));
+		sums[2] += std::abs(int8_t(uint8_t(current[i] - above[i])));
+	}
+	int filter = 0;
+	if (sums[1] < sums[filter]) filter = 1;
+	if (sums[2] < sums[filter]) filter = 2;
+
+	row.resize(n + 1);
+	row[0] = uint8_t(filter);
+	for (size_t i = 0; i < n; i++)
+	{
+		uint8_t predictor = 0;
+		if (filter == 1 && i >= 4) predictor = current[i - 4];
+		if (filter == 2) predictor = above[i];
+		row[i + 1] = uint8_t(current[i] - predictor);
+	}
+}
+
+/*
+Writes the signature, the header, the compressed rows and the end of the file
+*/
+bool writePng(std::ostream & out, const uint32_t * pixels, int width, int height)
+{
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	out.write(reinterpret_cast<const char *>(signature), 8);
+
+	uint8_t header[13] = {
+		uint8_t(width >> 24), uint8_t(width >> 16), uint8_t(width >> 8), uint8_t(width),
+		uint8_t(height >> 24), uint8_t(height >> 16), uint8_t(height >> 8), uint8_t(height),
+		8, 6, 0, 0, 0
+	};
+	writeChunk(out, "IHDR", header, sizeof(header));
+
+	size_t row_bytes = size_t(width) * 4;
+	std::vector<uint8_t> above(row_bytes, 0);
+	std::vector<uint8_t> current(row_bytes);
+	std::vector<uint8_t> previous_row;
+	std::vector<uint8_t> row;
+	Deflater deflater(out, row_bytes + 1);
+	for (int y = 0; y < height; y++)
+	{
+		const uint32_t * p = pixels + size_t(y) * size_t(width);
+		for (int x = 0; x < width; x++)
+		{
+			current[size_t(x) * 4] = uint8_t(p[x]);
+			current[size_t(x) * 4 + 1] = uint8_t(p[x] >> 8);
+			current[size_t(x) * 4 + 2] = uint8_t(p[x] >> 16);
+			current[size_t(x) * 4 + 3] = uint8_t(p[x] >> 24);
+		}
+		filterRow(above, current, row);
+		deflater.addRow(previous_row, row);
+		previous_row.swap(row);
+		above.swap(current);
+	}
+	deflater.finish();
+
+	writeChunk(out, "IEND", nullptr, 0);
+	return bool(out);
+}
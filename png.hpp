@@ -0,0 +1,13 @@
+#ifndef PNG_H
+#define PNG_H
+
+#pragma once
+#include <cstdint>
+#include <ostream>
+
+/*
+Writes an image of packed RGBA pixels (red in the lowest byte) as an 8-bit RGBA PNG; returns false if the stream fails
+*/
+bool writePng(std::ostream & out, const uint32_t * pixels, int width, int height);
+
+#endif
@@ -0,0 +1,164 @@
+#include "parser.hpp"
+#include <algorithm>
+
+/*
+Analyses a body in order, every statement of it reading only what the statements before it made readable
+*/
+static bool isPure(Span<InFunctionStatement*> statements, purity_check & c)
+{
+	for (InFunctionStatement ** i = statements.begin(); i != statements.end(); i++)
+	{
+		if (*i != nullptr && !(*i)->isPure(c)) return false;
+	}
+	return true;
+}
+
+/*
+Returns true if every call of the function with the same arguments gives the same result and has no other effect:
+the body does not move or draw with the turtle, read its state, make global variables, print, scan or sleep, reads
+no variable but its parameters and the local variables it made, and calls only functions which are pure as well
+*/
+bool FunctionDefinition::isPure(ProgramContext * pc)
+{
+	purity_analysis analysis;
+	return isPure(pc, analysis);
+}
+
+/*
+Analyses the function unless it was analysed since the last function was defined or its analysis is already
+in progress, in which case a recursive call is assumed to be pure and the function is decided by the rest of its body.
+The verdict is kept unless it is pure only by assuming a function analysed around it is: that one may still prove impure
+*/
+bool FunctionDefinition::isPure(ProgramContext * pc, purity_analysis & analysis)
+{
+	if (purity_generation == pc->getFunctionGeneration()) return pure;
+	std::vector<FunctionDefinition *>::const_iterator i = std::find(analysis.in_progress.begin(), analysis.in_progress.end(), this);
+	if (i != analysis.in_progress.end())
+	{
+		analysis.assumed = std::min(analysis.assumed, size_t(i - analysis.in_progress.begin()));
+		return true;
+	}
+
+	purity_check c;
+	c.pc = pc;
+	c.readable.assign(arguments.begin(), arguments.end());
+	c.analysis = &analysis;
+
+	size_t depth = analysis.in_progress.size();
+	size_t assumed_outside = analysis.assumed;
+	analysis.assumed = SIZE_MAX;
+	analysis.in_progress.push_back(this);
+	bool verdict = ::isPure(statementList, c);
+	analysis.in_progress.pop_back();
+	if (!verdict || analysis.assumed >= depth)
+	{
+		pure = verdict;
+		purity_generation = pc->getFunctionGeneration();
+	}
+	analysis.assumed = std::min(analysis.assumed, assumed_outside);
+	return verdict;
+}
+
+/*
+A variable is pure if it is made by the function reading it, otherwise the dynamic scoping reads it from the caller
+*/
+bool Variable::isPure(const purity_check & c)
+{
+	return std::find(c.readable.begin(), c.readable.end(), identifier.integer_value) != c.readable.end();
+}
+
+/*
+A call is pure if its arguments are and the called function, as defined at the moment, is pure
+*/
+bool Function::isPure(purity_check & c)
+{
+	for (AdditiveExpression ** i = argument_list.begin(); i != argument_list.end(); i++)
+	{
+		if (!(*i)->isPure(c)) return false;
+	}
+	FunctionDefinition * f = c.pc->getFunction(identifier.integer_value);
+	return f != nullptr && f->isPure(c.pc, *c.analysis);
+}
+
+/*
+An additive expression is pure if every operand of its flattened form is
+*/
+bool AdditiveExpression::isPure(purity_check & c)
+{
+	for (expression_term * t = terms.begin(); t != terms.end(); t++)
+	{
+		for (expression_factor * f = t->factors.begin(); f != t->factors.end(); f++)
+		{
+			if (f->type == MultiplicativeExpression::M_VARIABLE && !f->variable->isPure(c)) return false;
+			if (f->type == MultiplicativeExpression::M_FUNCTION && !f->function->isPure(c)) return false;
+			if (f->type == MultiplicativeExpression::M_PARENTHESIS && !f->additive_expression_in_parentheses->isPure(c)) return false;
+		}
+	}
+	return true;
+}
+
+/*
+A logical expression is pure if its operands are
+*/
+bool LogicalExpression::isPure(purity_check & c)
+{
+	switch (logical_type)
+	{
+	case L_COMPARISON:
+		return first_operand->isPure(c) && last_operand->isPure(c);
+	case L_UNARY:
+	case L_BRACES:
+		return logical_expression_set->isPure(c);
+	default:
+		return true;
+	}
+}
+
+/*
+A set of logical expressions is pure if its operands are
+*/
+bool LogicalExpressionSet::isPure(purity_check & c)
+{
+	return first_operand->isPure(c) && (!has_last_operand || last_operand->isPure(c));
+}
+
+/*
+An output statement is pure if the value it returns is
+*/
+bool Output::isPure(purity_check & c)
+{
+	return additive_exp->isPure(c);
+}
+
+/*
+Making a local variable is pure if its value is, and makes the variable readable by the statements after it;
+scanning it reads from the user
+*/
+bool LocalMakeScan::isPure(purity_check & c)
+{
+	if (isScan || !assigned_value->isPure(c)) return false;
+	c.readable.push_back(identifier.integer_value);
+	return true;
+}
+
+/*
+An if statement is pure if its condition and its body are; the variables made in the body, which may not run,
+stay unreadable after it
+*/
+bool IfStatement::isPure(purity_check & c)
+{
+	if (!condition->isPure(c)) return false;
+	purity_check body = c;
+	return ::isPure(statementList, body);
+}
+
+/*
+A repeat statement is pure if its count and its body are; the variables made in the body, which may not run,
+stay unreadable after it
+*/
+bool RepeatStatement::isPure(purity_check & c)
+{
+	if (!number_of_repetitions->isPure(c)) return false;
+	purity_check body = c;
+	return ::isPure(statementList, body);
+}
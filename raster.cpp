@@ -0,0 +1,476 @@
+#include "raster.hpp"
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+#include "png.hpp"
+#include "tiledraster.hpp"
+
+/*
+Writes the framebuffer to a PNG file; returns false if the file cannot be written
+*/
+bool Framebuffer::writePng(const std::string & path) const
+{
+	std::ofstream out(path, std::ios::binary);
+	if (!out) return false;
+	return ::writePng(out, pixels.data(), width, height);
+}
+
+/*
+Returns true if the line lies wholly on one side of the clipping rectangle
+*/
+inline bool LineRasterizer::outside(int x1, int y1, int x2, int y2) const
+{
+	return (x1 < clip.left && x2 < clip.left) || (y1 < clip.top && y2 < clip.top) ||
+		(x1 >= clip.right && x2 >= clip.right) || (y1 >= clip.bottom && y2 >= clip.bottom);
+}
+
+/*
+Sets a pixel to the color of the pen if it is inside the clipping rectangle
+*/
+inline void LineRasterizer::plot(int x, int y)
+{
+	if (x >= clip.left && x < clip.right && y >= clip.top && y < clip.bottom) framebuffer.row(y)[x] = color;
+}
+
+/*
+Mixes the color of the pen into a pixel with a weight from 0 to 255, if the pixel is inside the clipping rectangle
+*/
+inline void LineRasterizer::blend(int x, int y, unsigned weight)
+{
+	if (x < clip.left || x >= clip.right || y < clip.top || y >= clip.bottom) return;
+	uint32_t & p = framebuffer.row(y)[x];
+	uint32_t mixed = 0xff000000u;
+	for (int shift = 0; shift < 24; shift += 8)
+	{
+		unsigned background = (p >> shift) & 0xff;
+		unsigned pen = (color >> shift) & 0xff;
+		mixed |= ((background * (255 - weight) + pen * weight + 127) / 255) << shift;
+	}
+	p = mixed;
+}
+
+/*
+Fills the pixels of a row between two columns, both included, clipped to the rectangle
+*/
+void LineRasterizer::fillRow(int y, int x1, int x2)
+{
+	if (y < clip.top || y >= clip.bottom) return;
+	if (x1 > x2) std::swap(x1, x2);
+	x1 = std::max(x1, clip.left);
+	x2 = std::min(x2, clip.right - 1);
+	if (x1 <= x2) fill_span(framebuffer.row(y) + x1, size_t(x2 - x1 + 1), color);
+}
+
+/*
+Fills the pixels of a column between two rows, both included, clipped to the rectangle
+*/
+void LineRasterizer::fillColumn(int x, int y1, int y2)
+{
+	if (x < clip.left || x >= clip.right) return;
+	if (y1 > y2) std::swap(y1, y2);
+	y1 = std::max(y1, clip.top);
+	y2 = std::min(y2, clip.bottom - 1);
+	if (y1 > y2) return;
+	size_t stride = size_t(framebuffer.getWidth());
+	uint32_t * p = framebuffer.row(y1) + x;
+	for (int y = y1; y <= y2; y++, p += stride)
+	{
+		*p = color;
+	}
+}
+
+/*
+Fills the clipping rectangle with a color
+*/
+void LineRasterizer::clear(uint32_t c)
+{
+	if (clip.left == 0 && clip.right == framebuffer.getWidth())
+	{
+		fill_span(framebuffer.row(clip.top), size_t(clip.right) * size_t(clip.bottom - clip.top), c);
+		return;
+	}
+	for (int y = clip.top; y < clip.bottom; y++)
+	{
+		fill_span(framebuffer.row(y) + clip.left, size_t(clip.right - clip.left), c);
+	}
+}
+
+/*
+Steps of the algorithm of Bresenham along the major axis of a line: after k steps the minor coordinate has moved
+by the rounding of k * minor / major, halves rounded up, so the range of steps which keeps the minor coordinate between
+two bounds, and the runs of steps sharing one minor coordinate, follow from a division. The extents are below 2^32 and
+the steps and minor offsets within them, so each product of two of them is taken in 64 unsigned bits and divided first,
+the remainder deciding the rounding
+*/
+struct bresenham_steps
+{
+	long long major;
+	long long minor;
+
+	long long minorAt(long long k) const;
+	long long firstReaching(long long m) const;
+	long long lastBefore(long long m) const;
+	long long floorAt(long long k, long long & remainder) const;
+	long long firstFloorReaching(long long m) const;
+	long long lastFloorBefore(long long m) const;
+};
+
+/*
+Returns the minor offset after k steps, the rounding of (2 * minor * k + major) / (2 * major) down
+*/
+long long bresenham_steps::minorAt(long long k) const
+{
+	uint64_t product = uint64_t(minor) * uint64_t(k);
+	uint64_t remainder = product % uint64_t(major);
+	return (long long)(product / uint64_t(major)) + (2 * remainder >= uint64_t(major) ? 1 : 0);
+}
+
+/*
+Returns the first step at which the minor offset reaches m, the rounding of major * (2 * m - 1) / (2 * minor) up
+*/
+long long bresenham_steps::firstReaching(long long m) const
+{
+	if (m <= 0) return 0;
+	uint64_t product = uint64_t(major) * uint64_t(m);
+	long long rest = 2 * (long long)(product % uint64_t(minor)) - major;
+	long long carry = rest >= 0 ? (rest + 2 * minor - 1) / (2 * minor) : -(-rest / (2 * minor));
+	return (long long)(product / uint64_t(minor)) + carry;
+}
+
+/*
+Returns the last step before the minor offset passes m, the rounding of (major * (2 * m + 1) - 1) / (2 * minor) down
+*/
+long long bresenham_steps::lastBefore(long long m) const
+{
+	if (m >= minor) return major;
+	uint64_t product = uint64_t(major) * uint64_t(m);
+	long long rest = 2 * (long long)(product % uint64_t(minor)) + major - 1;
+	return (long long)(product / uint64_t(minor)) + rest / (2 * minor);
+}
+
+/*
+Returns the whole part of k * minor / major, the exact minor offset after k steps, and gives the remainder of the division
+*/
+long long bresenham_steps::floorAt(long long k, long long & remainder) const
+{
+	uint64_t product = uint64_t(minor) * uint64_t(k);
+	remainder = (long long)(product % uint64_t(major));
+	return (long long)(product / uint64_t(major));
+}
+
+/*
+Returns the first step whose exact minor offset has a whole part of m or more, the rounding of m * major / minor up
+*/
+long long bresenham_steps::firstFloorReaching(long long m) const
+{
+	if (m <= 0) return 0;
+	return (long long)((uint64_t(m) * uint64_t(major) + uint64_t(minor) - 1) / uint64_t(minor));
+}
+
+/*
+Returns the last step whose exact minor offset has a whole part of m or less, the rounding of ((m + 1) * major - 1) / minor down
+*/
+long long bresenham_steps::lastFloorBefore(long long m) const
+{
+	if (m >= minor) return major;
+	return (long long)((uint64_t(m + 1) * uint64_t(major) - 1) / uint64_t(minor));
+}
+
+/*
+Range of the offsets along one axis, from a coordinate going in a direction, which fall within two bounds, the first
+included and the last excluded; empty if first > last
+*/
+static void offsetRange(long long from, int direction, int low, int high, long long & first, long long & last)
+{
+	if (direction > 0)
+	{
+		first = low - from;
+		last = high - 1 - from;
+	}
+	else
+	{
+		first = from - (high - 1);
+		last = from - low;
+	}
+}
+
+/*
+Tells whether a line is stepped along the horizontal axis, which it is when it is at least as wide as tall
+*/
+bool LineRasterizer::horizontalMajor(int x1, int y1, int x2, int y2)
+{
+	return std::llabs((long long)x2 - x1) >= std::llabs((long long)y2 - y1);
+}
+
+/*
+Finds the range of the coordinates along the minor axis of the pixels a line drawn with or without antialiasing can
+touch while its coordinate along the major axis is between two bounds, the first included and the last excluded;
+returns false if the line does not reach between them. The steps are bounded as when drawing, so the range is exact
+for an aliased line and one pixel wider at most for an antialiased one
+*/
+bool LineRasterizer::minorRange(int x1, int y1, int x2, int y2, bool antialias, int low, int high, long long & minor_low, long long & minor_high)
+{
+	long long dx = std::llabs((long long)x2 - x1);
+	long long dy = std::llabs((long long)y2 - y1);
+	bool horizontal = dx >= dy;
+	if (dx == 0 && dy == 0)
+	{
+		if (x1 < low || x1 >= high) return false;
+		minor_low = minor_high = y1;
+		return true;
+	}
+
+	bresenham_steps steps = { horizontal ? dx : dy, horizontal ? dy : dx };
+	long long major_from = horizontal ? x1 : y1;
+	long long minor_from = horizontal ? y1 : x1;
+	int major_direction = horizontal ? (x1 < x2 ? 1 : -1) : (y1 < y2 ? 1 : -1);
+	int minor_direction = horizontal ? (y1 < y2 ? 1 : -1) : (x1 < x2 ? 1 : -1);
+
+	long long first, last;
+	offsetRange(major_from, major_direction, low, high, first, last);
+	first = std::max(first, 0LL);
+	last = std::min(last, steps.major);
+	if (first > last) return false;
+
+	long long m_first, m_last;
+	if (antialias)
+	{
+		long long remainder;
+		m_first = steps.floorAt(first, remainder);
+		m_last = steps.floorAt(last, remainder) + 1;
+	}
+	else
+	{
+		m_first = steps.minorAt(first);
+		m_last = steps.minorAt(last);
+	}
+	long long a = minor_from + minor_direction * m_first;
+	long long b = minor_from + minor_direction * m_last;
+	minor_low = std::min(a, b);
+	minor_high = std::max(a, b);
+	return true;
+}
+
+/*
+Draws a line with the integer algorithm of Bresenham, both end points included. Horizontal and vertical lines are
+filled directly; other lines are walked a run at a time along their major axis, a run being the pixels sharing
+a row (for a line closer to the horizontal) or a column, over the steps which stay inside the rectangle
+*/
+void LineRasterizer::drawLine(int x1, int y1, int x2, int y2)
+{
+	if (outside(x1, y1, x2, y2)) return;
+	if (y1 == y2)
+	{
+		fillRow(y1, x1, x2);
+		return;
+	}
+	if (x1 == x2)
+	{
+		fillColumn(x1, y1, y2);
+		return;
+	}
+
+	long long dx = std::llabs((long long)x2 - x1);
+	long long dy = std::llabs((long long)y2 - y1);
+	int sx = x1 < x2 ? 1 : -1;
+	int sy = y1 < y2 ? 1 : -1;
+	bool horizontal = dx >= dy;
+	bresenham_steps steps = { horizontal ? dx : dy, horizontal ? dy : dx };
+	long long major_from = horizontal ? x1 : y1;
+	long long minor_from = horizontal ? y1 : x1;
+	int major_direction = horizontal ? sx : sy;
+	int minor_direction = horizontal ? sy : sx;
+
+	long long first, last, minor_first, minor_last;
+	if (horizontal)
+	{
+		offsetRange(major_from, major_direction, clip.left, clip.right, first, last);
+		offsetRange(minor_from, minor_direction, clip.top, clip.bottom, minor_first, minor_last);
+	}
+	else
+	{
+		offsetRange(major_from, major_direction, clip.top, clip.bottom, first, last);
+		offsetRange(minor_from, minor_direction, clip.left, clip.right, minor_first, minor_last);
+	}
+	minor_first = std::max(minor_first, 0LL);
+	minor_last = std::min(minor_last, steps.minor);
+	if (minor_first > minor_last) return;
+	first = std::max(std::max(first, 0LL), steps.firstReaching(minor_first));
+	last = std::min(std::min(last, steps.major), steps.lastBefore(minor_last));
+
+	for (long long k = first; k <= last;)
+	{
+		long long m = steps.minorAt(k);
+		long long end = std::min(last, steps.lastBefore(m));
+		int minor = int(minor_from + minor_direction * m);
+		int run_first = int(major_from + major_direction * k);
+		int run_last = int(major_from + major_direction * end);
+		if (horizontal) fillRow(minor, run_first, run_last);
+		else fillColumn(minor, run_first, run_last);
+		k = end + 1;
+	}
+}
+
+/*
+Draws an antialiased line in the manner of Wu: every step along the major axis splits the intensity between the two
+pixels straddling the ideal line by their distance to it, the end points being drawn at full intensity. The ideal minor
+offset after k steps is k * minor / major, whose whole part and fraction come from one division, so every step is exact
+wherever the line is clipped, and only the steps whose pixels can fall inside the rectangle are walked
+*/
+void LineRasterizer::drawLineAntialiased(int x1, int y1, int x2, int y2)
+{
+	if (outside(x1, y1, x2, y2)) return;
+
+	long long dx = std::llabs((long long)x2 - x1);
+	long long dy = std::llabs((long long)y2 - y1);
+	if (dx == 0 || dy == 0 || dx == dy)
+	{
+		drawLine(x1, y1, x2, y2);
+		return;
+	}
+
+	int sx = x1 < x2 ? 1 : -1;
+	int sy = y1 < y2 ? 1 : -1;
+	bool horizontal = dx > dy;
+	bresenham_steps steps = { horizontal ? dx : dy, horizontal ? dy : dx };
+	long long major_from = horizontal ? x1 : y1;
+	long long minor_from = horizontal ? y1 : x1;
+	int major_direction = horizontal ? sx : sy;
+	int minor_direction = horizontal ? sy : sx;
+
+	long long first, last, minor_first, minor_last;
+	if (horizontal)
+	{
+		offsetRange(major_from, major_direction, clip.left, clip.right, first, last);
+		offsetRange(minor_from, minor_direction, clip.top, clip.bottom, minor_first, minor_last);
+	}
+	else
+	{
+		offsetRange(major_from, major_direction, clip.top, clip.bottom, first, last);
+		offsetRange(minor_from, minor_direction, clip.left, clip.right, minor_first, minor_last);
+	}
+	minor_first = std::max(minor_first - 1, 0LL);
+	minor_last = std::min(minor_last, steps.minor);
+	first = std::max(std::max(first, 1LL), steps.firstFloorReaching(minor_first));
+	last = std::min(std::min(last, steps.major - 1), steps.lastFloorBefore(minor_last));
+
+	plot(x1, y1);
+	for (long long k = first; k <= last; k++)
+	{
+		long long remainder;
+		long long m = steps.floorAt(k, remainder);
+		unsigned weight = unsigned((uint64_t(remainder) << 8) / uint64_t(steps.major));
+		int major = int(major_from + major_direction * k);
+		int minor = int(minor_from + minor_direction * m);
+		if (horizontal)
+		{
+			blend(major, minor, 255 - weight);
+			blend(major, minor + minor_direction, weight);
+		}
+		else
+		{
+			blend(minor, major, 255 - weight);
+			blend(minor + minor_direction, major, weight);
+		}
+	}
+	plot(x2, y2);
+}
+
+/*
+Constructor; the canvas starts white and the pen black, as in the window
+*/
+RasterSink::RasterSink(int width, int height, bool a) : framebuffer(width, height),
+	rasterizer(framebuffer, raster_clip{ 0, 0, width, height }, nullptr), antialias(a), color(Framebuffer::pack(0, 0, 0)),
+	kernel(bestSpanKernel()), fill_span(getSpanFill(kernel)), tiles(nullptr)
+{
+	rasterizer.setSpanFill(fill_span);
+	clearScreen();
+}
+
+/*
+Destructor
+*/
+RasterSink::~RasterSink()
+{
+	delete tiles;
+}
+
+/*
+Selects the kernel filling the runs of pixels; returns false, keeping the current one, if the processor does not support it
+*/
+bool RasterSink::setSpanKernel(span_kernel k)
+{
+	span_fill f = getSpanFill(k);
+	if (f == nullptr) return false;
+	kernel = k;
+	fill_span = f;
+	rasterizer.setSpanFill(f);
+	return true;
+}
+
+/*
+Sets the number of threads drawing the batches of calls, one drawing them in order on the calling thread
+*/
+void RasterSink::setThreads(unsigned n)
+{
+	delete tiles;
+	tiles = n > 1 ? new TiledRasterizer(n) : nullptr;
+}
+
+/*
+Returns the number of threads drawing the batches of calls
+*/
+unsigned RasterSink::getThreads() const
+{
+	return tiles != nullptr ? tiles->getThreads() : 1;
+}
+
+/*
+Draws a line between two points
+*/
+void RasterSink::drawLine2Point(int x1, int y1, int x2, int y2)
+{
+	if (antialias) rasterizer.drawLineAntialiased(x1, y1, x2, y2);
+	else rasterizer.drawLine(x1, y1, x2, y2);
+}
+
+/*
+Draws a line from a point, a length and an angle, ending at the pixel the turtle ends at
+*/
+void RasterSink::drawLinePointAngleLength(int x1, int y1, int length, int angle)
+{
+	int x2, y2;
+	polarEndPoint(x1, y1, length, angle, x2, y2);
+	drawLine2Point(x1, y1, x2, y2);
+}
+
+/*
+Clears the canvas to white
+*/
+void RasterSink::clearScreen()
+{
+	rasterizer.clear(Framebuffer::pack(255, 255, 255));
+}
+
+/*
+Sets the color of the pen
+*/
+void RasterSink::updateColor(int r, int g, int b)
+{
+	color = Framebuffer::pack(r, g, b);
+	rasterizer.setColor(color);
+}
+
+/*
+Draws a batch of recorded calls, by tiles on several threads if more than one was set
+*/
+void RasterSink::drawCommands(const render_command * first, size_t count)
+{
+	if (tiles == nullptr)
+	{
+		RenderSink::drawCommands(first, count);
+		return;
+	}
+	tiles->draw(framebuffer, first, count, color, antialias, fill_span);
+	rasterizer.setColor(color);
+}
@@ -0,0 +1,115 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <string>
+#include "rendersink.hpp"
+#include "spanfill.hpp"
+
+/*
+Image in memory made of packed RGBA pixels, red in the lowest byte, stored row after row
+*/
+class Framebuffer
+{
+public:
+	Framebuffer(int w, int h) : width(w), height(h), pixels(size_t(w) * size_t(h)) {}
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	const uint32_t * data() const { return pixels.data(); }
+	uint32_t * row(int y) { return pixels.data() + size_t(y) * size_t(width); }
+	void fill(uint32_t color) { pixels.assign(pixels.size(), color); }
+	bool writePng(const std::string & path) const;
+
+	static uint32_t pack(int r, int g, int b) { return uint32_t(r & 0xff) | uint32_t(g & 0xff) << 8 | uint32_t(b & 0xff) << 16 | 0xff000000u; }
+
+private:
+	int width;
+	int height;
+	std::vector<uint32_t> pixels;
+};
+
+/*
+Rectangle of a canvas, from its first column and row included to its last column and row excluded
+*/
+struct raster_clip
+{
+	int left;
+	int top;
+	int right;
+	int bottom;
+};
+
+/*
+Draws lines of one pixel wide into a framebuffer, clipped to a rectangle of it. Every pixel of a line is computed
+from the end points alone, with the closed form of the steps of the algorithm of Bresenham (or of the exact coverage of Wu),
+so a line cut by the rectangle sets exactly the pixels of the whole line which are inside it, and the rectangles of
+a canvas can be drawn separately
+*/
+class LineRasterizer
+{
+public:
+	LineRasterizer(Framebuffer & f, const raster_clip & c, span_fill s) : framebuffer(f), clip(c), fill_span(s), color(Framebuffer::pack(0, 0, 0)) {}
+	void setColor(uint32_t c) { color = c; }
+	void setSpanFill(span_fill s) { fill_span = s; }
+	void drawLine(int x1, int y1, int x2, int y2);
+	void drawLineAntialiased(int x1, int y1, int x2, int y2);
+	void clear(uint32_t c);
+	static bool horizontalMajor(int x1, int y1, int x2, int y2);
+	static bool minorRange(int x1, int y1, int x2, int y2, bool antialias, int low, int high, long long & minor_low, long long & minor_high);
+
+private:
+	bool outside(int x1, int y1, int x2, int y2) const;
+	void plot(int x, int y);
+	void blend(int x, int y, unsigned weight);
+	void fillRow(int y, int x1, int x2);
+	void fillColumn(int x, int y1, int y2);
+
+	Framebuffer & framebuffer;
+	raster_clip clip;
+	span_fill fill_span;
+	uint32_t color;
+};
+
+class TiledRasterizer;
+
+/*
+Render sink drawing into a framebuffer without any GUI: lines one pixel wide with the integer algorithm
+of Bresenham, or antialiased with the one of Wu, on a white canvas cleared to white again by a clear of the screen.
+The horizontal runs of pixels of a line and the clears are filled by the widest span kernel the processor supports.
+With more than one thread, the batches of calls it is given are drawn by a TiledRasterizer, to the same pixels
+*/
+class RasterSink : public RenderSink
+{
+public:
+	RasterSink(int width = 500, int height = 500, bool antialias = false);
+	~RasterSink();
+	RasterSink(const RasterSink &) = delete;
+	RasterSink & operator=(const RasterSink &) = delete;
+	void drawLine2Point(int x1, int y1, int x2, int y2);
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle);
+	void moveTurtle2Point(int, int) {}
+	void moveTurtlePointAngleLength(int, int, int, int) {}
+	void clearScreen();
+	void updateColor(int r, int g, int b);
+	void drawCommands(const render_command * first, size_t count);
+
+	bool setSpanKernel(span_kernel k);
+	span_kernel getSpanKernel() const { return kernel; }
+	void setThreads(unsigned n);
+	unsigned getThreads() const;
+	const Framebuffer & getFramebuffer() const { return framebuffer; }
+	bool writePng(const std::string & path) const { return framebuffer.writePng(path); }
+
+private:
+	Framebuffer framebuffer;
+	LineRasterizer rasterizer;
+	bool antialias;
+	uint32_t color;
+	span_kernel kernel;
+	span_fill fill_span;
+	TiledRasterizer * tiles;
+};
+
+#endif
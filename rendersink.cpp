@@ -0,0 +1,256 @@
+#include "rendersink.hpp"
+
+RenderSink::~RenderSink(){}
+
+/*
+Reads the value of a scanned variable from the standard input
+*/
+int RenderSink::getValueFromUser(std::string s)
+{
+	int value = 0;
+	std::cerr << "Please input the value of the variable: " << s << std::endl;
+	std::cin >> value;
+	return value;
+}
+
+/*
+Draws a batch of recorded calls one by one; sinks which can draw a batch at once override it
+*/
+void RenderSink::drawCommands(const render_command * first, size_t count)
+{
+	for (const render_command * i = first; i != first + count; i++)
+	{
+		switch (i->type)
+		{
+		case RC_LINE:
+			drawLine2Point(i->a, i->b, i->c, i->d);
+			break;
+		case RC_LINE_POLAR:
+			drawLinePointAngleLength(i->a, i->b, i->c, i->d);
+			break;
+		case RC_MOVE:
+			moveTurtle2Point(i->a, i->b);
+			break;
+		case RC_MOVE_POLAR:
+			moveTurtlePointAngleLength(i->a, i->b, i->c, i->d);
+			break;
+		case RC_CLEAR:
+			clearScreen();
+			break;
+		case RC_COLOR:
+			updateColor(i->a, i->b, i->c);
+			break;
+		}
+	}
+}
+
+/*
+Records a line drawn between two points
+*/
+void RecordingSink::drawLine2Point(int x1, int y1, int x2, int y2)
+{
+	out << "line " << x1 << " " << y1 << " " << x2 << " " << y2 << "\n";
+}
+
+/*
+Records a line drawn from a point, a length and an angle
+*/
+void RecordingSink::drawLinePointAngleLength(int x1, int y1, int length, int angle)
+{
+	out << "line_polar " << x1 << " " << y1 << " " << length << " " << angle << "\n";
+}
+
+/*
+Records a move of the turtle to a given point
+*/
+void RecordingSink::moveTurtle2Point(int x2, int y2)
+{
+	out << "move " << x2 << " " << y2 << "\n";
+}
+
+/*
+Records a move of the turtle from a given point at an angle by length
+*/
+void RecordingSink::moveTurtlePointAngleLength(int x1, int y1, int length, int angle)
+{
+	out << "move_polar " << x1 << " " << y1 << " " << length << " " << angle << "\n";
+}
+
+/*
+Records a clear of the screen
+*/
+void RecordingSink::clearScreen()
+{
+	out << "clear\n";
+}
+
+/*
+Records a change of the pen color
+*/
+void RecordingSink::updateColor(int r, int g, int b)
+{
+	out << "color " << r << " " << g << " " << b << "\n";
+}
+
+/*
+Records a clear of the screen, dropping the pending calls it hides but keeping the last pen color they set
+*/
+void CommandBuffer::clearScreen()
+{
+	render_command color = { RC_CLEAR, 0, 0, 0, 0 };
+	for (std::vector<render_command>::reverse_iterator i = commands.rbegin(); i != commands.rend(); i++)
+	{
+		if (i->type == RC_COLOR)
+		{
+			color = *i;
+			break;
+		}
+	}
+	commands.clear();
+	commands.push_back({ RC_CLEAR, 0, 0, 0, 0 });
+	if (color.type == RC_COLOR) commands.push_back(color);
+}
+
+/*
+Draws the pending calls before asking the user, who sees the drawing made so far
+*/
+int CommandBuffer::getValueFromUser(std::string s)
+{
+	flush();
+	return target->getValueFromUser(s);
+}
+
+/*
+Hands all the pending calls to the target as one batch, and the target its own ones
+*/
+void CommandBuffer::flush()
+{
+	if (!commands.empty()) target->drawCommands(commands.data(), commands.size());
+	commands.clear();
+	last_flush = std::chrono::steady_clock::now();
+	target->flush();
+}
+
+/*
+Flushes the pending calls if a frame interval has passed since the last batch
+*/
+void CommandBuffer::flushIfFrameElapsed()
+{
+	if (std::chrono::steady_clock::now() - last_flush >= frame) flush();
+}
+
+/*
+Keeps a line back, merged into the one kept before if it continues it: it starts where that one ends, goes the same way,
+and no other call came in between. A line of no length at the end of the kept one adds no pixel and is dropped
+*/
+void CoalescingSink::addLine(const render_command & c, int from_x, int from_y, int to_x, int to_y)
+{
+	received++;
+	if (has_line && from_x == end_x && from_y == end_y)
+	{
+		long long dx = (long long)end_x - start_x;
+		long long dy = (long long)end_y - start_y;
+		long long ex = (long long)to_x - from_x;
+		long long ey = (long long)to_y - from_y;
+		if (ex == 0 && ey == 0) return;
+		if (dx == 0 && dy == 0)
+		{
+			line = c;
+			end_x = to_x;
+			end_y = to_y;
+			return;
+		}
+		if (dx * ey == dy * ex && dx * ex + dy * ey > 0)
+		{
+			end_x = to_x;
+			end_y = to_y;
+			merged = true;
+			return;
+		}
+	}
+	flushLine();
+	has_line = true;
+	merged = false;
+	line = c;
+	start_x = from_x;
+	start_y = from_y;
+	end_x = to_x;
+	end_y = to_y;
+}
+
+/*
+Draws the line kept back, as it was given if nothing was merged into it
+*/
+void CoalescingSink::flushLine()
+{
+	if (!has_line) return;
+	has_line = false;
+	drawn++;
+	if (merged) target->drawLine2Point(start_x, start_y, end_x, end_y);
+	else if (line.type == RC_LINE_POLAR) target->drawLinePointAngleLength(line.a, line.b, line.c, line.d);
+	else target->drawLine2Point(line.a, line.b, line.c, line.d);
+}
+
+/*
+Keeps back a line given by a point, a length and an angle, merged with the one before by its end point
+*/
+void CoalescingSink::drawLinePointAngleLength(int from_x, int from_y, int length, int angle)
+{
+	int to_x, to_y;
+	polarEndPoint(from_x, from_y, length, angle, to_x, to_y);
+	addLine({ RC_LINE_POLAR, from_x, from_y, length, angle }, from_x, from_y, to_x, to_y);
+}
+
+/*
+Draws the line kept back and moves the turtle
+*/
+void CoalescingSink::moveTurtle2Point(int to_x, int to_y)
+{
+	flushLine();
+	target->moveTurtle2Point(to_x, to_y);
+}
+
+/*
+Draws the line kept back and moves the turtle by a length at an angle
+*/
+void CoalescingSink::moveTurtlePointAngleLength(int from_x, int from_y, int length, int angle)
+{
+	flushLine();
+	target->moveTurtlePointAngleLength(from_x, from_y, length, angle);
+}
+
+/*
+Clears the screen, dropping the line kept back which it hides
+*/
+void CoalescingSink::clearScreen()
+{
+	has_line = false;
+	target->clearScreen();
+}
+
+/*
+Draws the line kept back in the color it was drawn with, then changes the color
+*/
+void CoalescingSink::updateColor(int r, int g, int b)
+{
+	flushLine();
+	target->updateColor(r, g, b);
+}
+
+/*
+Shows everything drawn so far before asking for the value
+*/
+int CoalescingSink::getValueFromUser(std::string s)
+{
+	flush();
+	return target->getValueFromUser(s);
+}
+
+/*
+Draws the line kept back and flushes the target
+*/
+void CoalescingSink::flush()
+{
+	flushLine();
+	target->flush();
+}
@@ -0,0 +1,157 @@
+#ifndef RENDERSINK_H
+#define RENDERSINK_H
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include "geometry.hpp"
+
+/*
+Kinds of drawing calls kept by a CommandBuffer
+*/
+enum render_command_type { RC_LINE, RC_LINE_POLAR, RC_MOVE, RC_MOVE_POLAR, RC_CLEAR, RC_COLOR };
+
+/*
+Drawing call recorded by a CommandBuffer with its arguments in order: the two points of a line or a move,
+the point, length and angle of a polar one, or the red, green and blue parts of a color
+*/
+struct render_command
+{
+	unsigned char type;
+	int a;
+	int b;
+	int c;
+	int d;
+};
+
+/*
+Abstract interface receiving the drawing calls made by the model
+*/
+class RenderSink
+{
+public:
+	RenderSink() = default;
+	virtual ~RenderSink() = 0;
+	virtual void drawLine2Point(int x1, int y1, int x2, int y2) = 0;
+	virtual void drawLinePointAngleLength(int x1, int y1, int length, int angle) = 0;
+	virtual void moveTurtle2Point(int x2, int y2) = 0;
+	virtual void moveTurtlePointAngleLength(int x1, int y1, int length, int angle) = 0;
+	virtual void clearScreen() = 0;
+	virtual void updateColor(int r, int g, int b) = 0;
+	virtual int getValueFromUser(std::string s);
+	virtual void drawCommands(const render_command * first, size_t count);
+	virtual void flush() {}
+};
+
+/*
+Render sink which discards all drawing calls
+*/
+class NullSink : public RenderSink
+{
+public:
+	NullSink() = default;
+	void drawLine2Point(int, int, int, int) {}
+	void drawLinePointAngleLength(int, int, int, int) {}
+	void moveTurtle2Point(int, int) {}
+	void moveTurtlePointAngleLength(int, int, int, int) {}
+	void clearScreen() {}
+	void updateColor(int, int, int) {}
+};
+
+/*
+Render sink which writes every drawing call as a line of text to a stream
+*/
+class RecordingSink : public RenderSink
+{
+public:
+	RecordingSink(std::ostream & o) : out(o) {}
+	void drawLine2Point(int x1, int y1, int x2, int y2);
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle);
+	void moveTurtle2Point(int x2, int y2);
+	void moveTurtlePointAngleLength(int x1, int y1, int length, int angle);
+	void clearScreen();
+	void updateColor(int r, int g, int b);
+
+private:
+	std::ostream & out;
+};
+
+/*
+Render sink which keeps the drawing calls in a compact buffer and hands them to its target in batches, when
+a frame interval has passed since the last batch or when flushed; the calls hidden by a clear of the screen
+are dropped before they are drawn
+*/
+class CommandBuffer : public RenderSink
+{
+public:
+	CommandBuffer(RenderSink * t, std::chrono::milliseconds f = std::chrono::milliseconds(16)) : target(t), frame(f), last_flush(std::chrono::steady_clock::now()) {}
+	void drawLine2Point(int x1, int y1, int x2, int y2) { add(RC_LINE, x1, y1, x2, y2); }
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle) { add(RC_LINE_POLAR, x1, y1, length, angle); }
+	void moveTurtle2Point(int x2, int y2) { add(RC_MOVE, x2, y2, 0, 0); }
+	void moveTurtlePointAngleLength(int x1, int y1, int length, int angle) { add(RC_MOVE_POLAR, x1, y1, length, angle); }
+	void clearScreen();
+	void updateColor(int r, int g, int b) { add(RC_COLOR, r, g, b, 0); }
+	int getValueFromUser(std::string s);
+	void flush();
+	size_t pending() const { return commands.size(); }
+
+private:
+	void add(int type, int a, int b, int c, int d);
+	void flushIfFrameElapsed();
+
+	static const size_t clock_interval = 256;
+	RenderSink * target;
+	std::chrono::milliseconds frame;
+	std::chrono::steady_clock::time_point last_flush;
+	std::vector<render_command> commands;
+};
+
+/*
+Appends a drawing call, checking the frame clock once every few hundred calls
+*/
+inline void CommandBuffer::add(int type, int a, int b, int c, int d)
+{
+	commands.push_back({ (unsigned char)type, a, b, c, d });
+	if (commands.size() % clock_interval == 0) flushIfFrameElapsed();
+}
+
+/*
+Render sink merging the consecutive lines of one color which continue each other in the same direction into one line
+before handing them to its target: the pen keeps the last line back until the next call shows whether it goes on.
+The end points being integers, a merged line goes through the same points as its parts and sets the same pixels
+with the algorithm of Bresenham; antialiased, only the shading next to the joints may differ
+*/
+class CoalescingSink : public RenderSink
+{
+public:
+	CoalescingSink(RenderSink * t) : target(t) {}
+	void drawLine2Point(int x1, int y1, int x2, int y2) { addLine({ RC_LINE, x1, y1, x2, y2 }, x1, y1, x2, y2); }
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle);
+	void moveTurtle2Point(int x2, int y2);
+	void moveTurtlePointAngleLength(int x1, int y1, int length, int angle);
+	void clearScreen();
+	void updateColor(int r, int g, int b);
+	int getValueFromUser(std::string s);
+	void flush();
+	size_t getLinesReceived() const { return received; }
+	size_t getLinesDrawn() const { return drawn; }
+
+private:
+	void addLine(const render_command & c, int x1, int y1, int x2, int y2);
+	void flushLine();
+
+	RenderSink * target;
+	bool has_line = false;
+	bool merged = false;
+	render_command line;
+	int start_x = 0;
+	int start_y = 0;
+	int end_x = 0;
+	int end_y = 0;
+	size_t received = 0;
+	size_t drawn = 0;
+};
+
+#endif
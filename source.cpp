@@ -1,53 +1,147 @@
-#include "source.hpp"
-
-/*
-Default constructor of the source, with default values
-*/
-Source::Source()
-{
-	source = "";
-	pos.byte_number = 0;
-	pos.column_number = 0;
-	pos.row_number = 0;
-}
-
-/*
-Returns next non-processed character from the source
-*/
-char Source::getNextChar()
-{
-	//TO DO change source to be flexible
-	if (pos.byte_number >= int(source.length())) return EOF;
-
-	char c = source[size_t(pos.byte_number)];
-
-	if (c == '\n')
-	{
-		pos.column_number = 0;
-		pos.row_number++;
-	}
-	else
-	{
-		pos.column_number++;
-	}
-
-	pos.byte_number++;
-
-	return c;
-}
-
-/*
-Returns current position of character that will be read
-*/
-position Source::getPosition()
-{
-	return pos;
-}
-
-void Source::addToSource(std::string s)
-{
-	source = std::string(s);
-	pos.byte_number = 0;
-	pos.column_number = 0;
-	pos.row_number = 0;
-}
+#include "source.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+Default constructor of the source, empty
+*/
+Source::Source()
+{
+	reset(owned.data(), 0);
+}
+
+/*
+Destructor, unmaps the file if one is mapped
+*/
+Source::~Source()
+{
+	unmap();
+}
+
+/*
+Returns the row and the column of the byte with the given number, building the index of line offsets on first use;
+bytes are mostly located in the order they are read, so the line of the last byte located is tried first
+*/
+position Source::locate(int byte_number)
+{
+	if (line_offsets.empty())
+	{
+		line_offsets.push_back(0);
+		for (const char * c = begin; c < end; c++)
+		{
+			if (*c == '\n') line_offsets.push_back(int(c - begin) + 1);
+		}
+		last_line = 0;
+	}
+
+	size_t line = last_line;
+	if (byte_number < line_offsets[line])
+	{
+		line = size_t(std::upper_bound(line_offsets.begin(), line_offsets.end(), byte_number) - line_offsets.begin()) - 1;
+	}
+	else if (line + 1 < line_offsets.size() && byte_number >= line_offsets[line + 1])
+	{
+		line = size_t(std::upper_bound(line_offsets.begin() + line + 1, line_offsets.end(), byte_number) - line_offsets.begin()) - 1;
+	}
+	last_line = line;
+	return { byte_number, byte_number - line_offsets[line], int(line) };
+}
+
+/*
+Replaces the source with a copy of the given string
+*/
+void Source::addToSource(std::string s)
+{
+	unmap();
+	owned = std::move(s);
+	reset(owned.data(), owned.length());
+}
+
+/*
+Replaces the source with a buffer owned by the caller, which has to outlive its use by the lexer
+*/
+void Source::wrap(const char * data, size_t length)
+{
+	unmap();
+	owned.clear();
+	reset(data, length);
+}
+
+/*
+Replaces the source with the contents of a file, mapped into memory where the system allows it;
+returns false if the file cannot be read
+*/
+bool Source::mapFile(const std::string & path)
+{
+	unmap();
+	owned.clear();
+	reset(owned.data(), 0);
+
+#if !defined(_WIN32)
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t length = size_t(st.st_size);
+	if (length > 0)
+	{
+		void * p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED)
+		{
+			close(fd);
+			return false;
+		}
+		madvise(p, length, MADV_SEQUENTIAL);
+		mapping = p;
+		mapping_length = length;
+		reset(static_cast<const char *>(p), length);
+	}
+	close(fd);
+	return true;
+#else
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	owned = buffer.str();
+	reset(owned.data(), owned.length());
+	return true;
+#endif
+}
+
+/*
+Starts reading the given buffer from its beginning
+*/
+void Source::reset(const char * data, size_t length)
+{
+	begin = data;
+	cursor = data;
+	end = data + length;
+	line_offsets.clear();
+}
+
+/*
+Releases the mapped file, if any
+*/
+void Source::unmap()
+{
+#if !defined(_WIN32)
+	if (mapping != nullptr) munmap(mapping, mapping_length);
+#endif
+	mapping = nullptr;
+	mapping_length = 0;
+}
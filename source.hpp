@@ -1,30 +1,56 @@
-#ifndef SOURCE_H
-#define SOURCE_H
-
-#pragma once
-#include <string>
-
-struct position
-{
-	int byte_number;
-	int column_number;
-	int row_number;
-};
-
-
-class Source
-{
-public:
-	Source();
-	char getNextChar();
-	position getPosition();
-	void addToSource(std::string s);
-
-private:
-	position pos;
-	std::string source;
-	
-
-};
-
-#endif
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdio>
+
+/*
+Position in the source; the row and the column are -1 until computed by Source::locate
+*/
+struct position
+{
+	int byte_number;
+	int column_number;
+	int row_number;
+};
+
+/*
+Text read by the lexer, one contiguous buffer which is either a copy owned by the source, a buffer owned by
+the caller or a memory-mapped file; rows and columns are only computed on demand from an index of line offsets
+*/
+class Source
+{
+public:
+	Source();
+	~Source();
+	Source(const Source &) = delete;
+	Source & operator=(const Source &) = delete;
+
+	char getNextChar() { return cursor < end ? *cursor++ : char(EOF); }
+	position getPosition() { return { int(cursor - begin), -1, -1 }; }
+	const char * getCursor() { return cursor; }
+	const char * getData() { return begin; }
+	size_t getLength() { return size_t(end - begin); }
+	position locate(int byte_number);
+
+	void addToSource(std::string s);
+	void wrap(const char * data, size_t length);
+	bool mapFile(const std::string & path);
+
+private:
+	void reset(const char * data, size_t length);
+	void unmap();
+
+	std::string owned;
+	const char * begin = nullptr;
+	const char * cursor = nullptr;
+	const char * end = nullptr;
+	void * mapping = nullptr;
+	size_t mapping_length = 0;
+	std::vector<int> line_offsets;
+	size_t last_line = 0;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "spanfill.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPANFILL_X86
+#include <immintrin.h>
+#endif
+
+/*
+Fills the run one pixel at a time; kept as a plain loop, not vectorized by the compiler, to serve as the reference
+*/
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-tree-vectorize")))
+#endif
+static void fillScalar(uint32_t * first, size_t count, uint32_t color)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		first[i] = color;
+	}
+}
+
+#ifdef SPANFILL_X86
+/*
+Fills the run four pixels at a time with unaligned 128-bit stores, the last store overlapping the one before it
+*/
+__attribute__((target("sse2")))
+static void fillSse2(uint32_t * first, size_t count, uint32_t color)
+{
+	if (count < 4)
+	{
+		fillScalar(first, count, color);
+		return;
+	}
+	__m128i v = _mm_set1_epi32(int(color));
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(first + i), v);
+	}
+	if (i < count) _mm_storeu_si128(reinterpret_cast<__m128i *>(first + count - 4), v);
+}
+
+/*
+Fills the run eight pixels at a time with unaligned 256-bit stores, the last store overlapping the one before it
+*/
+__attribute__((target("avx2")))
+static void fillAvx2(uint32_t * first, size_t count, uint32_t color)
+{
+	if (count < 8)
+	{
+		fillSse2(first, count, color);
+		return;
+	}
+	__m256i v = _mm256_set1_epi32(int(color));
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(first + i), v);
+	}
+	if (i < count) _mm256_storeu_si256(reinterpret_cast<__m256i *>(first + count - 8), v);
+}
+#endif
+
+/*
+Returns the kernel, or nullptr if the processor does not support it
+*/
+span_fill getSpanFill(span_kernel k)
+{
+	switch (k)
+	{
+	case SPAN_SCALAR:
+		return fillScalar;
+#ifdef SPANFILL_X86
+	case SPAN_SSE2:
+		return __builtin_cpu_supports("sse2") ? fillSse2 : nullptr;
+	case SPAN_AVX2:
+		return __builtin_cpu_supports("avx2") ? fillAvx2 : nullptr;
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+/*
+Returns the widest kernel the processor supports
+*/
+span_kernel bestSpanKernel()
+{
+	if (getSpanFill(SPAN_AVX2) != nullptr) return SPAN_AVX2;
+	if (getSpanFill(SPAN_SSE2) != nullptr) return SPAN_SSE2;
+	return SPAN_SCALAR;
+}
+
+/*
+Returns the name of the kernel, as given on the command line
+*/
+const char * spanKernelName(span_kernel k)
+{
+	static const char * const names[] = { "scalar", "sse2", "avx2" };
+	return names[k];
+}
@@ -0,0 +1,19 @@
+#ifndef SPANFILL_H
+#define SPANFILL_H
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/*
+Kernels filling a run of pixels with one color: plain stores, 128-bit SSE2 stores or 256-bit AVX2 stores
+*/
+enum span_kernel { SPAN_SCALAR, SPAN_SSE2, SPAN_AVX2 };
+
+typedef void (*span_fill)(uint32_t * first, size_t count, uint32_t color);
+
+span_fill getSpanFill(span_kernel k);
+span_kernel bestSpanKernel();
+const char * spanKernelName(span_kernel k);
+
+#endif
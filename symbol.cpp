@@ -0,0 +1,76 @@
+#include "symbol.hpp"
+#include <cstring>
+
+/*
+Returns the table shared by the lexer, the parser and the program context
+*/
+SymbolTable & SymbolTable::instance()
+{
+	static SymbolTable t;
+	return t;
+}
+
+/*
+Constructor of the empty table
+*/
+SymbolTable::SymbolTable()
+{
+	buckets.assign(64, -1);
+}
+
+/*
+Returns the id of the given name, adding it to the table if it was not seen before
+*/
+SymbolId SymbolTable::intern(const char * s, size_t length)
+{
+	size_t h = hash(s, length);
+	size_t mask = buckets.size() - 1;
+	for (size_t i = h & mask; ; i = (i + 1) & mask)
+	{
+		SymbolId id = buckets[i];
+		if (id < 0)
+		{
+			id = SymbolId(names.size());
+			names.push_back(std::string(s, length));
+			hashes.push_back(h);
+			buckets[i] = id;
+			if (names.size() * 2 > buckets.size()) grow();
+			return id;
+		}
+
+		const std::string & name = names[size_t(id)];
+		if (hashes[size_t(id)] == h && name.length() == length && std::memcmp(name.data(), s, length) == 0)
+		{
+			return id;
+		}
+	}
+}
+
+/*
+Returns the FNV-1a hash of a name
+*/
+size_t SymbolTable::hash(const char * s, size_t length)
+{
+	size_t h = 2166136261u;
+	for (size_t i = 0; i < length; i++)
+	{
+		h ^= (unsigned char)s[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/*
+Doubles the number of buckets and reinserts all names
+*/
+void SymbolTable::grow()
+{
+	buckets.assign(buckets.size() * 2, -1);
+	size_t mask = buckets.size() - 1;
+	for (size_t id = 0; id < names.size(); id++)
+	{
+		size_t i = hashes[id] & mask;
+		while (buckets[i] >= 0) i = (i + 1) & mask;
+		buckets[i] = SymbolId(id);
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+
+typedef int SymbolId;
+
+/*
+Global table of identifiers: every distinct name is stored once and represented everywhere else by its SymbolId
+*/
+class SymbolTable
+{
+public:
+	static SymbolTable & instance();
+	SymbolId intern(const char * s, size_t length);
+	SymbolId intern(const std::string & s) { return intern(s.data(), s.length()); }
+	const std::string & getName(SymbolId id) { return names[size_t(id)]; }
+	int size() { return int(names.size()); }
+
+private:
+	SymbolTable();
+	static size_t hash(const char * s, size_t length);
+	void grow();
+
+	std::vector<std::string> names;
+	std::vector<size_t> hashes;
+	std::vector<SymbolId> buckets;
+};
+
+#endif
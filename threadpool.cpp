@@ -0,0 +1,79 @@
+#include "threadpool.hpp"
+
+/*
+Constructor; starts the threads besides the calling one
+*/
+ThreadPool::ThreadPool(unsigned threads)
+{
+	for (unsigned i = 1; i < threads; i++)
+	{
+		workers.push_back(std::thread(&ThreadPool::work, this));
+	}
+}
+
+/*
+Destructor; stops and joins the threads
+*/
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::vector<std::thread>::iterator i = workers.begin(); i != workers.end(); i++)
+	{
+		i->join();
+	}
+}
+
+/*
+Runs the task for every number from 0 to count excluded, on the threads and the calling one, and waits for all of them
+*/
+void ThreadPool::run(size_t count, const std::function<void(size_t)> & task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &task;
+		job_size = count;
+		next_task.store(0, std::memory_order_relaxed);
+		busy = workers.size();
+		generation++;
+	}
+	wake.notify_all();
+	runTasks();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this]() { return busy == 0; });
+	job = nullptr;
+}
+
+/*
+Takes the tasks of the current job until none is left
+*/
+void ThreadPool::runTasks()
+{
+	for (size_t i = next_task.fetch_add(1); i < job_size; i = next_task.fetch_add(1))
+	{
+		(*job)(i);
+	}
+}
+
+/*
+Loop of a thread: waits for a job, takes a share of its tasks and reports when there is none left
+*/
+void ThreadPool::work()
+{
+	unsigned long seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;)
+	{
+		wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+		if (stopping) return;
+		seen = generation;
+		lock.unlock();
+		runTasks();
+		lock.lock();
+		if (--busy == 0) done.notify_one();
+	}
+}
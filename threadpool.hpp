@@ -0,0 +1,44 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+Fixed set of threads running the tasks of one job at a time: the tasks are numbered, taken in turn from a shared
+counter by the threads and by the caller, which returns once all of them are done
+*/
+class ThreadPool
+{
+public:
+	explicit ThreadPool(unsigned threads);
+	~ThreadPool();
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool & operator=(const ThreadPool &) = delete;
+
+	void run(size_t count, const std::function<void(size_t)> & task);
+	unsigned getThreads() const { return unsigned(workers.size()) + 1; }
+
+private:
+	void work();
+	void runTasks();
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	const std::function<void(size_t)> * job = nullptr;
+	size_t job_size = 0;
+	std::atomic<size_t> next_task{ 0 };
+	size_t busy = 0;
+	unsigned long generation = 0;
+	bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "tiledraster.hpp"
+#include <algorithm>
+
+/*
+Adds a line to the tiles it crosses: the tiles are walked a band at a time along the major axis of the line, a column
+of tiles for a line closer to the horizontal or a row, and in each band the line is added to the tiles holding the
+pixels it can touch there, found with the bounds on its steps the rasterizer clips with
+*/
+void TiledRasterizer::bin(const Framebuffer & framebuffer, size_t index, bool antialias)
+{
+	const tile_line & l = lines[index];
+	bool horizontal = LineRasterizer::horizontalMajor(l.x1, l.y1, l.x2, l.y2);
+	int extent = horizontal ? framebuffer.getWidth() : framebuffer.getHeight();
+	int across = horizontal ? framebuffer.getHeight() : framebuffer.getWidth();
+	long long major_1 = horizontal ? l.x1 : l.y1;
+	long long major_2 = horizontal ? l.x2 : l.y2;
+	long long low = std::max(std::min(major_1, major_2), 0LL);
+	long long high = std::min(std::max(major_1, major_2), (long long)extent - 1);
+	if (low > high) return;
+
+	for (int band = int(low / size); band <= int(high / size); band++)
+	{
+		long long minor_low, minor_high;
+		if (!LineRasterizer::minorRange(l.x1, l.y1, l.x2, l.y2, antialias, band * size, std::min((band + 1) * size, extent), minor_low, minor_high)) continue;
+		minor_low = std::max(minor_low, 0LL);
+		minor_high = std::min(minor_high, (long long)across - 1);
+		for (int t = int(minor_low / size); minor_low <= minor_high && t <= int(minor_high / size); t++)
+		{
+			int row = horizontal ? t : band;
+			int column = horizontal ? band : t;
+			tiles[size_t(row) * size_t(columns) + size_t(column)].push_back(uint32_t(index));
+		}
+	}
+}
+
+/*
+Draws the batch: resolves the colors and end points of the lines in order, sorts them into the tiles and draws
+the tiles on the threads; the color of the pen is updated to the one at the end of the batch
+*/
+void TiledRasterizer::draw(Framebuffer & framebuffer, const render_command * first, size_t count, uint32_t & color, bool antialias, span_fill fill)
+{
+	columns = (framebuffer.getWidth() + size - 1) / size;
+	rows = (framebuffer.getHeight() + size - 1) / size;
+	tiles.resize(size_t(columns) * size_t(rows));
+	for (std::vector<std::vector<uint32_t>>::iterator i = tiles.begin(); i != tiles.end(); i++)
+	{
+		i->clear();
+	}
+	lines.clear();
+
+	bool cleared = false;
+	for (const render_command * i = first; i != first + count; i++)
+	{
+		int x2, y2;
+		switch (i->type)
+		{
+		case RC_LINE:
+			lines.push_back({ i->a, i->b, i->c, i->d, color });
+			break;
+		case RC_LINE_POLAR:
+			polarEndPoint(i->a, i->b, i->c, i->d, x2, y2);
+			lines.push_back({ i->a, i->b, x2, y2, color });
+			break;
+		case RC_CLEAR:
+			lines.clear();
+			cleared = true;
+			break;
+		case RC_COLOR:
+			color = Framebuffer::pack(i->a, i->b, i->c);
+			break;
+		}
+	}
+	if (!cleared && lines.empty()) return;
+	for (size_t i = 0; i < lines.size(); i++)
+	{
+		bin(framebuffer, i, antialias);
+	}
+
+	pool.run(tiles.size(), [&](size_t t)
+	{
+		int column = int(t % size_t(columns));
+		int row = int(t / size_t(columns));
+		raster_clip clip = { column * size, row * size, std::min((column + 1) * size, framebuffer.getWidth()), std::min((row + 1) * size, framebuffer.getHeight()) };
+		LineRasterizer rasterizer(framebuffer, clip, fill);
+		if (cleared) rasterizer.clear(Framebuffer::pack(255, 255, 255));
+		for (std::vector<uint32_t>::const_iterator i = tiles[t].begin(); i != tiles[t].end(); i++)
+		{
+			const tile_line & l = lines[*i];
+			rasterizer.setColor(l.color);
+			if (antialias) rasterizer.drawLineAntialiased(l.x1, l.y1, l.x2, l.y2);
+			else rasterizer.drawLine(l.x1, l.y1, l.x2, l.y2);
+		}
+	});
+}
@@ -0,0 +1,47 @@
+#ifndef TILEDRASTER_H
+#define TILEDRASTER_H
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "raster.hpp"
+#include "threadpool.hpp"
+
+/*
+Line of a batch with its end points resolved and the color it is drawn with
+*/
+struct tile_line
+{
+	int x1;
+	int y1;
+	int x2;
+	int y2;
+	uint32_t color;
+};
+
+/*
+Draws a batch of recorded drawing calls into a framebuffer on several threads. The lines are first sorted into
+square tiles of the canvas by the pixels they can touch, each tile keeping them in the order they were drawn, then the
+tiles are drawn in parallel, each clipped to itself. A pixel belongs to one tile and receives the same lines in the
+same order as when the batch is drawn call by call, so the image is the same to the bit. A clear of the screen drops
+the lines before it and makes every tile start white
+*/
+class TiledRasterizer
+{
+public:
+	explicit TiledRasterizer(unsigned threads, int tile_size = 128) : pool(threads), size(tile_size) {}
+	void draw(Framebuffer & framebuffer, const render_command * first, size_t count, uint32_t & color, bool antialias, span_fill fill);
+	unsigned getThreads() const { return pool.getThreads(); }
+
+private:
+	void bin(const Framebuffer & framebuffer, size_t index, bool antialias);
+
+	ThreadPool pool;
+	int size;
+	int columns = 0;
+	int rows = 0;
+	std::vector<tile_line> lines;
+	std::vector<std::vector<uint32_t>> tiles;
+};
+
+#endif
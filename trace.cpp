@@ -0,0 +1,296 @@
+#include "trace.hpp"
+#include <cstring>
+
+/*
+Version of the trace format written after the magic
+*/
+static const char trace_magic[] = { 'L', 'G', 'T', 'R', 1 };
+
+/*
+The kinds of records are replayed as the kinds of drawing calls of the same value
+*/
+static_assert(int(TRACE_LINE) == int(RC_LINE), "trace lines must replay as RC_LINE");
+static_assert(int(TRACE_LINE_POLAR) == int(RC_LINE_POLAR), "trace polar lines must replay as RC_LINE_POLAR");
+static_assert(int(TRACE_MOVE) == int(RC_MOVE), "trace moves must replay as RC_MOVE");
+static_assert(int(TRACE_MOVE_POLAR) == int(RC_MOVE_POLAR), "trace polar moves must replay as RC_MOVE_POLAR");
+static_assert(int(TRACE_CLEAR) == int(RC_CLEAR), "trace clears must replay as RC_CLEAR");
+static_assert(int(TRACE_COLOR) == int(RC_COLOR), "trace colors must replay as RC_COLOR");
+
+/*
+Number of decoded calls handed to the sink at once by replayTrace
+*/
+static const size_t replay_batch = 4096;
+
+/*
+Constructor; writes the header of the trace
+*/
+TraceRecorder::TraceRecorder(std::ostream & o, RenderSink * n) : buffer(o), next(n)
+{
+	buffer.write(trace_magic, sizeof(trace_magic));
+}
+
+/*
+Writes the byte starting a record and the start point, left out if the turtle is already there
+*/
+void TraceRecorder::writeStart(int kind, int x1, int y1)
+{
+	records++;
+	if (x1 == last_x && y1 == last_y)
+	{
+		buffer.put(char(kind | TRACE_FROM_LAST));
+		return;
+	}
+	buffer.put(char(kind));
+	writeNumber((long long)x1 - last_x);
+	writeNumber((long long)y1 - last_y);
+}
+
+/*
+Writes a line or a move given by a point, a length and an angle, and follows the turtle to its end
+*/
+void TraceRecorder::writePolar(int kind, int x1, int y1, int length, int angle)
+{
+	writeStart(kind, x1, y1);
+	writeNumber(length);
+	writeNumber((long long)angle - last_angle);
+	last_angle = angle;
+	polarEndPoint(x1, y1, length, angle, last_x, last_y);
+}
+
+/*
+Records a line from two points
+*/
+void TraceRecorder::drawLine2Point(int x1, int y1, int x2, int y2)
+{
+	writeStart(TRACE_LINE, x1, y1);
+	writeNumber((long long)x2 - x1);
+	writeNumber((long long)y2 - y1);
+	last_x = x2;
+	last_y = y2;
+	if (next != nullptr) next->drawLine2Point(x1, y1, x2, y2);
+}
+
+/*
+Records a line from a point, a length and an angle
+*/
+void TraceRecorder::drawLinePointAngleLength(int x1, int y1, int length, int angle)
+{
+	writePolar(TRACE_LINE_POLAR, x1, y1, length, angle);
+	if (next != nullptr) next->drawLinePointAngleLength(x1, y1, length, angle);
+}
+
+/*
+Records a move of the turtle to a point, as its difference from the point the turtle was at
+*/
+void TraceRecorder::moveTurtle2Point(int x2, int y2)
+{
+	records++;
+	buffer.put(char(TRACE_MOVE));
+	writeNumber((long long)x2 - last_x);
+	writeNumber((long long)y2 - last_y);
+	last_x = x2;
+	last_y = y2;
+	if (next != nullptr) next->moveTurtle2Point(x2, y2);
+}
+
+/*
+Records a move of the turtle from a point at an angle by length
+*/
+void TraceRecorder::moveTurtlePointAngleLength(int x1, int y1, int length, int angle)
+{
+	writePolar(TRACE_MOVE_POLAR, x1, y1, length, angle);
+	if (next != nullptr) next->moveTurtlePointAngleLength(x1, y1, length, angle);
+}
+
+/*
+Records a clear of the screen
+*/
+void TraceRecorder::clearScreen()
+{
+	records++;
+	buffer.put(char(TRACE_CLEAR));
+	if (next != nullptr) next->clearScreen();
+}
+
+/*
+Records a change of the color
+*/
+void TraceRecorder::updateColor(int r, int g, int b)
+{
+	records++;
+	buffer.put(char(TRACE_COLOR));
+	writeNumber(r);
+	writeNumber(g);
+	writeNumber(b);
+	if (next != nullptr) next->updateColor(r, g, b);
+}
+
+/*
+Asks the next sink for the value, or answers like a sink with no user
+*/
+int TraceRecorder::getValueFromUser(std::string s)
+{
+	if (next != nullptr) return next->getValueFromUser(s);
+	return RenderSink::getValueFromUser(s);
+}
+
+/*
+Writes the recorded part of the trace out and flushes the next sink
+*/
+void TraceRecorder::flush()
+{
+	buffer.flush();
+	if (next != nullptr) next->flush();
+}
+
+/*
+Writes the rest of the trace, returns false if the stream failed
+*/
+bool TraceRecorder::finish()
+{
+	buffer.flush();
+	return buffer.good();
+}
+
+/*
+Reads trace numbers one at a time, failing at the end of the data or at a varint too long for 64 bits
+*/
+class TraceReader
+{
+public:
+	TraceReader(const char * d, size_t length) : data((const unsigned char *)d), end(data + length) {}
+	bool atEnd() const { return data == end; }
+	bool readByte(int & v);
+	bool readNumber(long long & v);
+	bool readInt(int & v);
+
+private:
+	const unsigned char * data;
+	const unsigned char * end;
+};
+
+/*
+Reads the byte starting a record
+*/
+bool TraceReader::readByte(int & v)
+{
+	if (data == end) return false;
+	v = *data++;
+	return true;
+}
+
+/*
+Reads a zigzag varint
+*/
+bool TraceReader::readNumber(long long & v)
+{
+	uint64_t u = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (data == end) return false;
+		unsigned char c = *data++;
+		u |= uint64_t(c & 0x7f) << shift;
+		if ((c & 0x80) == 0)
+		{
+			v = (long long)(u >> 1) ^ -(long long)(u & 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+Reads a zigzag varint which is a whole number by itself, like a length or a color part
+*/
+bool TraceReader::readInt(int & v)
+{
+	long long n;
+	if (!readNumber(n)) return false;
+	v = int(n);
+	return true;
+}
+
+/*
+Decodes a trace into drawing calls and hands them to the sink in batches, without running any script;
+returns false if the data is not a trace or ends inside a record, the calls before the fault having been drawn
+*/
+bool replayTrace(const char * data, size_t length, RenderSink * sink)
+{
+	if (length < sizeof(trace_magic) || std::memcmp(data, trace_magic, sizeof(trace_magic)) != 0) return false;
+	TraceReader reader(data + sizeof(trace_magic), length - sizeof(trace_magic));
+	std::vector<render_command> batch;
+	batch.reserve(replay_batch);
+	int last_x = 0;
+	int last_y = 0;
+	int last_angle = 0;
+	bool ok = true;
+
+	while (ok && !reader.atEnd())
+	{
+		int head;
+		reader.readByte(head);
+		int kind = head & ~TRACE_FROM_LAST;
+		render_command c = { (unsigned char)kind, 0, 0, 0, 0 };
+		long long dx = 0;
+		long long dy = 0;
+		if (kind == TRACE_LINE || kind == TRACE_LINE_POLAR || kind == TRACE_MOVE_POLAR)
+		{
+			c.a = last_x;
+			c.b = last_y;
+			if ((head & TRACE_FROM_LAST) == 0)
+			{
+				ok = reader.readNumber(dx) && reader.readNumber(dy);
+				c.a = int(last_x + dx);
+				c.b = int(last_y + dy);
+			}
+		}
+		else if (head != kind)
+		{
+			ok = false;
+		}
+
+		if (!ok) break;
+		switch (kind)
+		{
+		case TRACE_LINE:
+			ok = reader.readNumber(dx) && reader.readNumber(dy);
+			c.c = int(c.a + dx);
+			c.d = int(c.b + dy);
+			last_x = c.c;
+			last_y = c.d;
+			break;
+		case TRACE_LINE_POLAR:
+		case TRACE_MOVE_POLAR:
+			ok = reader.readInt(c.c) && reader.readNumber(dx);
+			c.d = int(last_angle + dx);
+			last_angle = c.d;
+			polarEndPoint(c.a, c.b, c.c, c.d, last_x, last_y);
+			break;
+		case TRACE_MOVE:
+			ok = reader.readNumber(dx) && reader.readNumber(dy);
+			c.a = int(last_x + dx);
+			c.b = int(last_y + dy);
+			last_x = c.a;
+			last_y = c.b;
+			break;
+		case TRACE_CLEAR:
+			break;
+		case TRACE_COLOR:
+			ok = reader.readInt(c.a) && reader.readInt(c.b) && reader.readInt(c.c);
+			break;
+		default:
+			ok = false;
+		}
+
+		if (!ok) break;
+		batch.push_back(c);
+		if (batch.size() == replay_batch)
+		{
+			sink->drawCommands(batch.data(), batch.size());
+			batch.clear();
+		}
+	}
+
+	if (!batch.empty()) sink->drawCommands(batch.data(), batch.size());
+	return ok;
+}
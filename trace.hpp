@@ -0,0 +1,53 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include "rendersink.hpp"
+#include "outputbuffer.hpp"
+
+/*
+Kinds of records of a drawing trace, in the low bits of the byte starting a record; TRACE_FROM_LAST marks a line
+starting where the turtle was left by the record before, whose start point is then not written
+*/
+enum trace_record { TRACE_LINE, TRACE_LINE_POLAR, TRACE_MOVE, TRACE_MOVE_POLAR, TRACE_CLEAR, TRACE_COLOR, TRACE_FROM_LAST = 0x08 };
+
+/*
+Render sink recording the drawing calls into a compact binary trace, and passing them on to another sink if given.
+The trace is the magic "LGTR" and a version byte, then one record per call. Every number of a record is a varint of
+its zigzag encoding (small magnitudes first, whatever the sign) and is written as a difference: a start point from
+the point the turtle was left at, an end point from the start point, an angle from the angle before; the colors are
+written as they are
+*/
+class TraceRecorder : public RenderSink
+{
+public:
+	TraceRecorder(std::ostream & o, RenderSink * n = nullptr);
+	void drawLine2Point(int x1, int y1, int x2, int y2);
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle);
+	void moveTurtle2Point(int x2, int y2);
+	void moveTurtlePointAngleLength(int x1, int y1, int length, int angle);
+	void clearScreen();
+	void updateColor(int r, int g, int b);
+	int getValueFromUser(std::string s);
+	void flush();
+	bool finish();
+	size_t getRecords() const { return records; }
+
+private:
+	void writeStart(int kind, int x1, int y1);
+	void writePolar(int kind, int x1, int y1, int length, int angle);
+	void writeNumber(long long v) { buffer.writeVarint(uint64_t(v) << 1 ^ uint64_t(v >> 63)); }
+
+	OutputBuffer buffer;
+	RenderSink * next;
+	int last_x = 0;
+	int last_y = 0;
+	int last_angle = 0;
+	size_t records = 0;
+};
+
+bool replayTrace(const char * data, size_t length, RenderSink * sink);
+
+#endif
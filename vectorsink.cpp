@@ -0,0 +1,181 @@
+#include "vectorsink.hpp"
+
+/*
+Constructor; writes the start of the document and a white canvas, the lines being shifted by half a pixel onto
+the centers of the pixels, where the rasterizers draw them
+*/
+SvgSink::SvgSink(std::ostream & o, int w, int h) : buffer(o), width(w), height(h)
+{
+	buffer.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+	buffer.writeDecimal(width);
+	buffer.write("\" height=\"");
+	buffer.writeDecimal(height);
+	buffer.write("\" viewBox=\"0 0 ");
+	buffer.writeDecimal(width);
+	buffer.put(' ');
+	buffer.writeDecimal(height);
+	buffer.write("\">\n<g transform=\"translate(0.5 0.5)\" fill=\"none\" stroke-width=\"1\" stroke-linecap=\"square\">\n");
+	writeBackground();
+}
+
+/*
+Writes a white rectangle over the whole canvas
+*/
+void SvgSink::writeBackground()
+{
+	buffer.write("<rect x=\"-0.5\" y=\"-0.5\" width=\"");
+	buffer.writeDecimal(width);
+	buffer.write("\" height=\"");
+	buffer.writeDecimal(height);
+	buffer.write("\" fill=\"#ffffff\"/>\n");
+}
+
+/*
+Adds a line to the path of the current color, opening one if needed
+*/
+void SvgSink::drawLine2Point(int x1, int y1, int x2, int y2)
+{
+	if (path_open && path_lines >= max_path_lines) closePath();
+	if (!path_open)
+	{
+		static const char hex[] = "0123456789abcdef";
+		char stroke[8] = { '#' };
+		for (int i = 0; i < 3; i++)
+		{
+			stroke[1 + 2 * i] = hex[(color >> (8 * i + 4)) & 0xf];
+			stroke[2 + 2 * i] = hex[(color >> (8 * i)) & 0xf];
+		}
+		buffer.write("<path stroke=\"");
+		buffer.write(stroke, 7);
+		buffer.write("\" d=\"");
+		path_open = true;
+		path_lines = 0;
+		paths++;
+	}
+
+	if (path_lines == 0 || x1 != pen_x || y1 != pen_y)
+	{
+		buffer.put('M');
+		buffer.writeDecimal(x1);
+		buffer.put(' ');
+		buffer.writeDecimal(y1);
+		line_to = false;
+	}
+	buffer.put(line_to ? ' ' : 'l');
+	buffer.writeDecimal((long long)x2 - x1);
+	buffer.put(' ');
+	buffer.writeDecimal((long long)y2 - y1);
+	line_to = true;
+	pen_x = x2;
+	pen_y = y2;
+	path_lines++;
+	lines++;
+}
+
+/*
+Adds a line given by a point, a length and an angle
+*/
+void SvgSink::drawLinePointAngleLength(int x1, int y1, int length, int angle)
+{
+	int x2, y2;
+	polarEndPoint(x1, y1, length, angle, x2, y2);
+	drawLine2Point(x1, y1, x2, y2);
+}
+
+/*
+Ends the path being written
+*/
+void SvgSink::closePath()
+{
+	if (!path_open) return;
+	buffer.write("\"/>\n");
+	path_open = false;
+}
+
+/*
+Paints the canvas white over what was drawn before
+*/
+void SvgSink::clearScreen()
+{
+	closePath();
+	writeBackground();
+}
+
+/*
+Sets the color of the lines drawn next, ending the path if it changes
+*/
+void SvgSink::updateColor(int r, int g, int b)
+{
+	uint32_t c = uint32_t(r & 0xff) | uint32_t(g & 0xff) << 8 | uint32_t(b & 0xff) << 16;
+	if (c == color) return;
+	closePath();
+	color = c;
+}
+
+/*
+Ends the document and writes out the buffer; returns false if the stream failed
+*/
+bool SvgSink::finish()
+{
+	if (!finished)
+	{
+		closePath();
+		buffer.write("</g>\n</svg>\n");
+		finished = true;
+	}
+	buffer.flush();
+	return buffer.good();
+}
+
+/*
+Constructor; writes the header of the list
+*/
+LineListSink::LineListSink(std::ostream & o, int width, int height) : buffer(o)
+{
+	buffer.write("LGLN", 4);
+	buffer.put(1);
+	buffer.writeLittleEndian(uint32_t(width), 4);
+	buffer.writeLittleEndian(uint32_t(height), 4);
+}
+
+/*
+Writes a line record
+*/
+void LineListSink::drawLine2Point(int x1, int y1, int x2, int y2)
+{
+	buffer.put(char(LL_LINE));
+	buffer.writeLittleEndian(uint32_t(x1), 4);
+	buffer.writeLittleEndian(uint32_t(y1), 4);
+	buffer.writeLittleEndian(uint32_t(x2), 4);
+	buffer.writeLittleEndian(uint32_t(y2), 4);
+}
+
+/*
+Writes the line record of a line given by a point, a length and an angle
+*/
+void LineListSink::drawLinePointAngleLength(int x1, int y1, int length, int angle)
+{
+	int x2, y2;
+	polarEndPoint(x1, y1, length, angle, x2, y2);
+	drawLine2Point(x1, y1, x2, y2);
+}
+
+/*
+Writes a color record
+*/
+void LineListSink::updateColor(int r, int g, int b)
+{
+	buffer.put(char(LL_COLOR));
+	buffer.put(char(r & 0xff));
+	buffer.put(char(g & 0xff));
+	buffer.put(char(b & 0xff));
+}
+
+/*
+Writes out the buffer; returns false if the stream failed
+*/
+bool LineListSink::finish()
+{
+	buffer.flush();
+	return buffer.good();
+}
@@ -0,0 +1,78 @@
+#ifndef VECTORSINK_H
+#define VECTORSINK_H
+
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include "rendersink.hpp"
+#include "outputbuffer.hpp"
+
+/*
+Render sink streaming the drawing to an SVG document as it is made, holding nothing but the path being written.
+The lines of one color are written into one <path>, the ones continuing the line before it with a relative line-to
+and the others starting with a move-to, until the color changes or the path grows to max_path_lines lines.
+A clear of the screen paints the canvas white again over what was drawn before
+*/
+class SvgSink : public RenderSink
+{
+public:
+	SvgSink(std::ostream & o, int width = 500, int height = 500);
+	~SvgSink() { finish(); }
+	void drawLine2Point(int x1, int y1, int x2, int y2);
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle);
+	void moveTurtle2Point(int, int) {}
+	void moveTurtlePointAngleLength(int, int, int, int) {}
+	void clearScreen();
+	void updateColor(int r, int g, int b);
+	void flush() { buffer.flush(); }
+	bool finish();
+	size_t getPaths() const { return paths; }
+	size_t getLines() const { return lines; }
+
+private:
+	void closePath();
+	void writeBackground();
+
+	static const size_t max_path_lines = 4096;
+	OutputBuffer buffer;
+	int width;
+	int height;
+	uint32_t color = 0;
+	bool path_open = false;
+	bool line_to = false;
+	size_t path_lines = 0;
+	int pen_x = 0;
+	int pen_y = 0;
+	size_t paths = 0;
+	size_t lines = 0;
+	bool finished = false;
+};
+
+/*
+Kinds of records of a line list
+*/
+enum line_list_record { LL_LINE = 'L', LL_COLOR = 'C', LL_CLEAR = 'X' };
+
+/*
+Render sink streaming the drawing to a compact binary list of lines: the magic "LGLN", a version byte, the width
+and height of the canvas, then one record per call, a line as its kind and four 32-bit end point coordinates,
+a color as its kind and three bytes, a clear as its kind alone; all the numbers are little endian
+*/
+class LineListSink : public RenderSink
+{
+public:
+	LineListSink(std::ostream & o, int width = 500, int height = 500);
+	void drawLine2Point(int x1, int y1, int x2, int y2);
+	void drawLinePointAngleLength(int x1, int y1, int length, int angle);
+	void moveTurtle2Point(int, int) {}
+	void moveTurtlePointAngleLength(int, int, int, int) {}
+	void clearScreen() { buffer.put(char(LL_CLEAR)); }
+	void updateColor(int r, int g, int b);
+	void flush() { buffer.flush(); }
+	bool finish();
+
+private:
+	OutputBuffer buffer;
+};
+
+#endif
@@ -0,0 +1,545 @@
+#include "vm.hpp"
+#include "parser.hpp"
+#include <algorithm>
+
+#if defined(__GNUC__)
+#define VM_COMPUTED_GOTO
+#endif
+
+#ifdef VM_COMPUTED_GOTO
+#define TARGET(op) L_##op:
+#define DISPATCH() goto *dispatch_table[*ip++]
+#else
+#define TARGET(op) case op:
+#define DISPATCH() continue
+#endif
+
+#define RAISE(e) do { error = (e); goto fail; } while (0)
+
+/*
+Executes a chunk compiled from a starting statement; returns false with the error which stopped the execution if one was raised
+*/
+bool VirtualMachine::execute(const Chunk * c, ProgramContext * pc, RuntimeError & error)
+{
+	stack.clear();
+	loops.assign(size_t(c->loop_slots), 0);
+	frames.clear();
+
+	vm_frame f;
+	f.chunk = c;
+	f.function = -1;
+	f.ip = 0;
+	f.loop_base = 0;
+	f.result_value = 0;
+	f.result_has_value = false;
+	f.result_is_output = false;
+	f.returns_to_expression = false;
+	f.memo = nullptr;
+	frames.push_back(f);
+
+	error_code code = run(pc);
+	if (code != E_NONE)
+	{
+		error = RuntimeError(code, frames.back().chunk->positionAt(frames.back().ip));
+		for (size_t i = frames.size() - 1; i > 0; i--)
+		{
+			error.trace.push_back({ frames[i].function, frames[i - 1].chunk->positionAt(frames[i - 1].ip) });
+			pc->popContext();
+		}
+	}
+
+	frames.clear();
+	memo_keys.clear();
+	return code == E_NONE;
+}
+
+/*
+Dispatch loop of the virtual machine; an error leaves the loop with the instruction pointer of the frame raising it saved
+*/
+error_code VirtualMachine::run(ProgramContext * pc)
+{
+#ifdef VM_COMPUTED_GOTO
+	static void * dispatch_table[] = {
+		&&L_OP_PUSH, &&L_OP_LOAD_GLOBAL, &&L_OP_LOAD_LOCAL, &&L_OP_NEG, &&L_OP_ADD, &&L_OP_SUB, &&L_OP_MUL, &&L_OP_DIV,
+		&&L_OP_LT, &&L_OP_GT, &&L_OP_EQ, &&L_OP_NE, &&L_OP_NOT,
+		&&L_OP_JMP, &&L_OP_JMP_FALSE, &&L_OP_JMP_TRUE,
+		&&L_OP_GETX, &&L_OP_GETY, &&L_OP_GETHEADING,
+		&&L_OP_FORWARD, &&L_OP_BACKWARD, &&L_OP_RIGHT, &&L_OP_LEFT, &&L_OP_MOVE_BY, &&L_OP_MOVE_TO,
+		&&L_OP_SET_HEADING, &&L_OP_HOME, &&L_OP_CLEAR, &&L_OP_PEN_UP, &&L_OP_PEN_DOWN, &&L_OP_SET_COLOR,
+		&&L_OP_PRINT, &&L_OP_PRINT_STRING, &&L_OP_SCAN, &&L_OP_MAKE, &&L_OP_LOCAL_MAKE, &&L_OP_LOCAL_SCAN,
+		&&L_OP_SLEEP, &&L_OP_DEFINE, &&L_OP_CLEAR_RESULT, &&L_OP_SET_RESULT,
+		&&L_OP_LOOP_INIT, &&L_OP_LOOP_TEST, &&L_OP_LOOP_NEXT,
+		&&L_OP_CALL, &&L_OP_CALL_STATEMENT, &&L_OP_TAIL_CALL, &&L_OP_OUTPUT, &&L_OP_PROPAGATE, &&L_OP_RETURN, &&L_OP_HALT
+	};
+	static_assert(sizeof(dispatch_table) / sizeof(dispatch_table[0]) == OP_COUNT, "dispatch table does not match op_code");
+#endif
+
+	vm_frame * fr = &frames.back();
+	const Chunk * chunk = fr->chunk;
+	const int * code = chunk->code.data();
+	const int * ip = code;
+	int * loop = loops.data();
+	int a, b, c;
+	error_code error = E_NONE;
+
+#ifdef VM_COMPUTED_GOTO
+	DISPATCH();
+#else
+	for (;;)
+	{
+		switch (*ip++)
+		{
+#endif
+
+	TARGET(OP_PUSH)
+		stack.push_back(*ip++);
+		DISPATCH();
+
+	TARGET(OP_LOAD_GLOBAL)
+		if (!pc->findVariable(*ip++, a)) RAISE(E_NONEXISTENT_VARIABLE);
+		stack.push_back(a);
+		DISPATCH();
+
+	TARGET(OP_LOAD_LOCAL)
+		if (!pc->findLocalVariable(*ip++, a)) RAISE(E_NONEXISTENT_VARIABLE);
+		stack.push_back(a);
+		DISPATCH();
+
+	TARGET(OP_NEG)
+		stack.back() = -stack.back();
+		DISPATCH();
+
+	TARGET(OP_ADD)
+		b = stack.back();
+		stack.pop_back();
+		stack.back() += b;
+		DISPATCH();
+
+	TARGET(OP_SUB)
+		b = stack.back();
+		stack.pop_back();
+		stack.back() -= b;
+		DISPATCH();
+
+	TARGET(OP_MUL)
+		b = stack.back();
+		stack.pop_back();
+		stack.back() *= b;
+		DISPATCH();
+
+	TARGET(OP_DIV)
+		b = stack.back();
+		stack.pop_back();
+		if (b == 0) RAISE(E_DIVISION_BY_ZERO);
+		stack.back() /= b;
+		DISPATCH();
+
+	TARGET(OP_LT)
+		b = stack.back();
+		stack.pop_back();
+		stack.back() = stack.back() < b;
+		DISPATCH();
+
+	TARGET(OP_GT)
+		b = stack.back();
+		stack.pop_back();
+		stack.back() = stack.back() > b;
+		DISPATCH();
+
+	TARGET(OP_EQ)
+		b = stack.back();
+		stack.pop_back();
+		stack.back() = stack.back() == b;
+		DISPATCH();
+
+	TARGET(OP_NE)
+		b = stack.back();
+		stack.pop_back();
+		stack.back() = stack.back() != b;
+		DISPATCH();
+
+	TARGET(OP_NOT)
+		stack.back() = !stack.back();
+		DISPATCH();
+
+	TARGET(OP_JMP)
+		ip = code + *ip;
+		DISPATCH();
+
+	TARGET(OP_JMP_FALSE)
+		a = stack.back();
+		stack.pop_back();
+		if (!a) ip = code + *ip;
+		else ip++;
+		DISPATCH();
+
+	TARGET(OP_JMP_TRUE)
+		a = stack.back();
+		stack.pop_back();
+		if (a) ip = code + *ip;
+		else ip++;
+		DISPATCH();
+
+	TARGET(OP_GETX)
+		stack.push_back(pc->getx());
+		DISPATCH();
+
+	TARGET(OP_GETY)
+		stack.push_back(pc->gety());
+		DISPATCH();
+
+	TARGET(OP_GETHEADING)
+		stack.push_back(pc->geth());
+		DISPATCH();
+
+	TARGET(OP_FORWARD)
+		a = stack.back();
+		stack.pop_back();
+		pc->move_forward(a);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_BACKWARD)
+		a = stack.back();
+		stack.pop_back();
+		pc->move_forward(-a);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_RIGHT)
+		a = stack.back();
+		stack.pop_back();
+		pc->turn_by(-a);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_LEFT)
+		a = stack.back();
+		stack.pop_back();
+		pc->turn_by(a);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_MOVE_BY)
+		b = stack.back();
+		stack.pop_back();
+		a = stack.back();
+		stack.pop_back();
+		pc->move_by(a, b);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_MOVE_TO)
+		b = stack.back();
+		stack.pop_back();
+		a = stack.back();
+		stack.pop_back();
+		pc->move_to(a, b);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_SET_HEADING)
+		a = stack.back();
+		stack.pop_back();
+		while (a > 3600) a -= 3600;
+		while (a < 0) a += 3600;
+		pc->set_heading(a);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_HOME)
+		pc->go_home();
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_CLEAR)
+		pc->clear_screen();
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_PEN_UP)
+		pc->pen_up();
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_PEN_DOWN)
+		pc->pen_down();
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_SET_COLOR)
+		c = stack.back();
+		stack.pop_back();
+		b = stack.back();
+		stack.pop_back();
+		a = stack.back();
+		stack.pop_back();
+		pc->set_color(a % 256, b % 256, c % 256);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_PRINT)
+		a = stack.back();
+		stack.pop_back();
+		pc->writeToLog(std::to_string(a));
+		pc->writeToLog("\n");
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_PRINT_STRING)
+		pc->writeToLog(chunk->strings[size_t(*ip++)]);
+		pc->writeToLog("\n");
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_SCAN)
+		a = *ip++;
+		pc->addVariable(a, pc->getValueFromUser(SymbolTable::instance().getName(a)));
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_MAKE)
+		a = stack.back();
+		stack.pop_back();
+		pc->addVariable(*ip++, a);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_LOCAL_MAKE)
+		a = stack.back();
+		stack.pop_back();
+		pc->setLocalVariable(*ip++, a);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_LOCAL_SCAN)
+		b = *ip++;
+		std::cout << "Please input the value of the local variable " << SymbolTable::instance().getName(b) << "." << std::endl;
+		std::cin >> a;
+		pc->addLocalVariable(b, a);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_SLEEP)
+		a = stack.back();
+		stack.pop_back();
+		if (a < 0) RAISE(E_NEGATIVE_SLEEP);
+		if (!pc->sleepFor(a)) RAISE(E_STOPPED);
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_DEFINE)
+		{
+			FunctionDefinition * f = chunk->functions[size_t(*ip++)];
+			f->execute(pc);
+		}
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_CLEAR_RESULT)
+		fr->result_has_value = false;
+		DISPATCH();
+
+	TARGET(OP_SET_RESULT)
+		fr->result_value = stack.back();
+		fr->result_has_value = true;
+		stack.pop_back();
+		DISPATCH();
+
+	TARGET(OP_LOOP_INIT)
+		loop[*ip++] = 0;
+		DISPATCH();
+
+	TARGET(OP_LOOP_TEST)
+		a = stack.back();
+		stack.pop_back();
+		if (a - loop[ip[0]] == 0) ip = code + ip[1];
+		else ip += 2;
+		DISPATCH();
+
+	TARGET(OP_LOOP_NEXT)
+		loop[ip[0]]++;
+		if (pc->isStopRequested()) RAISE(E_STOPPED);
+		ip = code + ip[1];
+		DISPATCH();
+
+	TARGET(OP_TAIL_CALL)
+		{
+			FunctionDefinition * f = pc->getFunction(ip[0]);
+			if (f == nullptr) RAISE(E_NONEXISTENT_FUNCTION);
+			int argc = ip[1];
+			Span<SymbolId> arguments = f->getArgList();
+			if (pc->isContextShadowedBy(arguments.begin(), std::min(size_t(argc), arguments.size())))
+			{
+				if (pc->isStopRequested()) RAISE(E_STOPPED);
+				const Chunk * body = f->getChunk();
+				size_t first = stack.size() - size_t(argc);
+				size_t count = std::min(size_t(argc), body->parameters.size());
+				pc->popContext();
+				pc->pushContext(body->locals);
+				for (size_t i = 0; i < count; i++)
+				{
+					pc->setLocalVariable(body->parameters[i], stack[first + i]);
+				}
+				stack.resize(first);
+
+				fr->chunk = body;
+				fr->function = ip[0];
+				fr->ip = 0;
+				fr->result_value = 0;
+				fr->result_has_value = false;
+				fr->result_is_output = false;
+				loops.resize(size_t(fr->loop_base + body->loop_slots));
+
+				chunk = body;
+				code = chunk->code.data();
+				ip = code;
+				loop = loops.data() + fr->loop_base;
+				DISPATCH();
+			}
+		}
+		/* the frame of the caller stays visible to the callee: falls back to a nested call */
+
+	TARGET(OP_CALL)
+	TARGET(OP_CALL_STATEMENT)
+		{
+			bool is_expression = ip[-1] == OP_CALL;
+			FunctionDefinition * f = pc->getFunction(ip[0]);
+			if (f == nullptr) RAISE(E_NONEXISTENT_FUNCTION);
+			SymbolId name = ip[0];
+			int argc = ip[1];
+			size_t first = stack.size() - size_t(argc);
+
+			memo_table * memo = pc->getMemo(name);
+			if (memo != nullptr)
+			{
+				std::vector<int> key(stack.begin() + std::ptrdiff_t(first), stack.end());
+				std::unordered_map<std::vector<int>, memo_result, argument_hash>::iterator found = memo->results.find(key);
+				if (found != memo->results.end())
+				{
+					memo->hits++;
+					stack.resize(first);
+					ip += 2;
+					if (is_expression)
+					{
+						if (!found->second.returns_a_value) RAISE(E_NO_RETURN_VALUE);
+						stack.push_back(found->second.integer_value);
+					}
+					else
+					{
+						fr->result_value = found->second.integer_value;
+						fr->result_has_value = found->second.returns_a_value;
+						fr->result_is_output = found->second.is_output;
+					}
+					DISPATCH();
+				}
+				memo->misses++;
+				memo_keys.push_back(std::move(key));
+			}
+
+			if (pc->isStopRequested()) RAISE(E_STOPPED);
+			if (frames.size() > size_t(pc->getMaxCallDepth())) RAISE(E_RECURSION_DEPTH);
+			ip += 2;
+
+			const Chunk * body = f->getChunk();
+			size_t count = std::min(size_t(argc), body->parameters.size());
+			pc->pushContext(body->locals);
+			for (size_t i = 0; i < count; i++)
+			{
+				pc->setLocalVariable(body->parameters[i], stack[first + i]);
+			}
+			stack.resize(first);
+
+			fr->ip = int(ip - code);
+			vm_frame callee;
+			callee.chunk = body;
+			callee.function = name;
+			callee.ip = 0;
+			callee.loop_base = fr->loop_base + chunk->loop_slots;
+			callee.result_value = 0;
+			callee.result_has_value = false;
+			callee.result_is_output = false;
+			callee.returns_to_expression = is_expression;
+			callee.memo = memo;
+			frames.push_back(callee);
+			loops.resize(size_t(callee.loop_base + callee.chunk->loop_slots));
+
+			fr = &frames.back();
+			chunk = fr->chunk;
+			code = chunk->code.data();
+			ip = code;
+			loop = loops.data() + fr->loop_base;
+		}
+		DISPATCH();
+
+	TARGET(OP_OUTPUT)
+		fr->result_value = stack.back();
+		fr->result_has_value = true;
+		stack.pop_back();
+		if (*ip < 0)
+		{
+			fr->result_is_output = true;
+			goto leave_function;
+		}
+		ip = code + *ip;
+		DISPATCH();
+
+	TARGET(OP_PROPAGATE)
+		if (!fr->result_is_output)
+		{
+			ip++;
+			DISPATCH();
+		}
+		if (*ip < 0) goto leave_function;
+		fr->result_is_output = false;
+		ip = code + *ip;
+		DISPATCH();
+
+	TARGET(OP_RETURN)
+	leave_function:
+		{
+			vm_frame callee = frames.back();
+			frames.pop_back();
+			pc->popContext();
+
+			if (callee.memo != nullptr)
+			{
+				callee.memo->results[std::move(memo_keys.back())] = { callee.result_value, callee.result_has_value, callee.result_is_output };
+				memo_keys.pop_back();
+			}
+
+			fr = &frames.back();
+			chunk = fr->chunk;
+			code = chunk->code.data();
+			ip = code + fr->ip;
+			loops.resize(size_t(fr->loop_base + chunk->loop_slots));
+			loop = loops.data() + fr->loop_base;
+
+			if (callee.returns_to_expression)
+			{
+				if (!callee.result_has_value) RAISE(E_NO_RETURN_VALUE);
+				stack.push_back(callee.result_value);
+			}
+			else
+			{
+				fr->result_value = callee.result_value;
+				fr->result_has_value = callee.result_has_value;
+				fr->result_is_output = callee.result_is_output;
+			}
+		}
+		DISPATCH();
+
+	TARGET(OP_HALT)
+		return E_NONE;
+
+#ifndef VM_COMPUTED_GOTO
+		default:
+			return E_NONE;
+		}
+	}
+#endif
+
+fail:
+	fr->ip = int(ip - code);
+	return error;
+}
@@ -0,0 +1,43 @@
+#ifndef VM_H
+#define VM_H
+
+#pragma once
+#include <vector>
+#include "bytecode.hpp"
+#include "context.hpp"
+
+/*
+Call frame of the virtual machine, one for the starting statement and one for every active function call
+*/
+struct vm_frame
+{
+	const Chunk * chunk;
+	SymbolId function;
+	int ip;
+	int loop_base;
+	int result_value;
+	bool result_has_value;
+	bool result_is_output;
+	bool returns_to_expression;
+	memo_table * memo;
+};
+
+/*
+Stack based virtual machine executing the bytecode produced by the Compiler
+*/
+class VirtualMachine
+{
+public:
+	VirtualMachine() = default;
+	bool execute(const Chunk * c, ProgramContext * pc, RuntimeError & error);
+
+private:
+	error_code run(ProgramContext * pc);
+
+	std::vector<int> stack;
+	std::vector<int> loops;
+	std::vector<vm_frame> frames;
+	std::vector<std::vector<int>> memo_keys;
+};
+
+#endif